@@ -0,0 +1,136 @@
+#pragma once
+// BitStream - bit-level writer and reader, and fixed-point quantization.
+//
+// Fields are written with the number of bits they need, least significant
+// bit first, packed without padding; the last byte is padded with zeros.
+// Reading past the end of the data returns zeros and clears ok(), so a
+// decoder can read a whole record and check once.
+//
+// A Quantizer maps a float range onto an unsigned integer of a given width:
+// min + q * step for q in [0, 2^bits). Values outside the range are clamped
+// to its ends. With a power-of-two step and an integer min, dequantized
+// values are exact floats, the same on every machine.
+//
+// Public API:
+//  - BitWriter(out): write(value, bits) / writeVarUint(value) / bits() /
+//    finish()                     appends to a byte vector; finish() flushes
+//                                 the last partial byte
+//  - BitReader(data, size): read(bits) -> uint32_t / readVarUint() /
+//    ok() / remainingBits()
+//  - varUintBits(value)           bits writeVarUint() takes
+//  - Quantizer{min, step, bits}: quantize(v) / dequantize(q) / snap(v)
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<char>& out) : _out(out) {}
+
+    // bits in [1, 32]; value must fit in them
+    void write(uint32_t value, unsigned bits) {
+        _buffer |= static_cast<uint64_t>(value) << _pending;
+        _pending += bits;
+        _bits += bits;
+        while (_pending >= 8) {
+            _out.push_back(static_cast<char>(_buffer & 0xFF));
+            _buffer >>= 8;
+            _pending -= 8;
+        }
+    }
+
+    // 4 bits at a time, each group followed by a "more" bit: 5 bits up to
+    // 15, 10 up to 255
+    void writeVarUint(uint32_t value) {
+        do {
+            uint32_t group = value & 0xF;
+            value >>= 4;
+            write(group | (value != 0 ? 0x10u : 0u), 5);
+        } while (value != 0);
+    }
+
+    std::size_t bits() const { return _bits; }
+
+    void finish() {
+        if (_pending > 0) {
+            _out.push_back(static_cast<char>(_buffer & 0xFF));
+            _buffer = 0;
+            _pending = 0;
+        }
+    }
+
+private:
+    std::vector<char>& _out;
+    uint64_t _buffer{0};
+    unsigned _pending{0};
+    std::size_t _bits{0};
+};
+
+inline std::size_t varUintBits(uint32_t value) {
+    std::size_t bits = 5;
+    while (value >>= 4) bits += 5;
+    return bits;
+}
+
+class BitReader {
+public:
+    BitReader(const char* data, std::size_t size) : _data(data), _size(size) {}
+
+    uint32_t read(unsigned bits) {
+        while (_pending < bits) {
+            if (_next == _size) {
+                _ok = false;
+                return 0;
+            }
+            _buffer |= static_cast<uint64_t>(static_cast<uint8_t>(_data[_next++])) << _pending;
+            _pending += 8;
+        }
+        uint32_t value = static_cast<uint32_t>(_buffer & ((uint64_t{1} << bits) - 1));
+        _buffer >>= bits;
+        _pending -= bits;
+        return value;
+    }
+
+    uint32_t readVarUint() {
+        uint32_t value = 0;
+        for (unsigned shift = 0; shift < 32; shift += 4) {
+            uint32_t group = read(5);
+            value |= (group & 0xF) << shift;
+            if (!(group & 0x10)) return value;
+        }
+        _ok = false;  // More than 32 bits
+        return 0;
+    }
+
+    bool ok() const { return _ok; }
+    std::size_t remainingBits() const { return (_size - _next) * 8 + _pending; }
+
+private:
+    const char* _data;
+    std::size_t _size;
+    std::size_t _next{0};
+    uint64_t _buffer{0};
+    unsigned _pending{0};
+    bool _ok{true};
+};
+
+struct Quantizer {
+    float min;
+    float step;
+    unsigned bits;
+
+    uint32_t maxValue() const { return bits >= 32 ? UINT32_MAX : (uint32_t{1} << bits) - 1; }
+
+    uint32_t quantize(float value) const {
+        double q = std::floor((static_cast<double>(value) - min) / step + 0.5);
+        if (!(q > 0.0)) return 0;  // Below the range, or NaN
+        return q >= maxValue() ? maxValue() : static_cast<uint32_t>(q);
+    }
+
+    float dequantize(uint32_t q) const { return min + static_cast<float>(q) * step; }
+
+    // The value the other side will read
+    float snap(float value) const { return dequantize(quantize(value)); }
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Collision.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Immutable compound collision shape: a set of local hitboxes + BVH
+ *
+ * A shape is built once per template (boss, large obstacle, ...) and shared
+ * by every entity using it through the CompoundCollider component. Hitboxes
+ * are expressed relative to the entity position (top-left corner).
+ *
+ * The bounding volume hierarchy is a flat array of nodes built top-down by
+ * median split on the longest axis, with up to LEAF_SIZE hitboxes per leaf.
+ * Queries descend only into nodes whose box overlaps the probe, so a probe
+ * missing a whole part of the shape rejects every hitbox below it at once.
+ */
+class ColliderShape {
+public:
+    explicit ColliderShape(std::vector<AABB> localBoxes);
+
+    // Local bounds of all hitboxes
+    const AABB& bounds() const noexcept { return _bounds; }
+
+    // True if the local-space probe overlaps any hitbox
+    bool overlaps(const AABB& localProbe) const;
+
+    // Sweep a local-space box by (dx, dy); returns the earliest time of impact
+    // over all hitboxes in toi (see sweptAABB)
+    bool sweep(const AABB& localStart, float dx, float dy, float& toi) const;
+
+    std::size_t boxCount() const noexcept { return _boxes.size(); }
+    std::size_t nodeCount() const noexcept { return _nodes.size(); }
+
+    static constexpr std::size_t LEAF_SIZE = 4;
+
+private:
+    struct Node {
+        AABB box;
+        uint32_t first;   // leaf: first hitbox index, inner: index of left child
+        uint32_t count;   // leaf: number of hitboxes, inner: 0 (right child = left + 1)
+    };
+
+    void buildNode(uint32_t node, uint32_t first, uint32_t count);
+
+    std::vector<AABB> _boxes;
+    std::vector<Node> _nodes;
+    AABB _bounds;
+};
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Axis-aligned bounding box in world coordinates (pixels)
+ *
+ * Entities are positioned by their top-left corner, so an entity box is
+ * { pos.x, pos.y, pos.x + width, pos.y + height }.
+ */
+struct AABB {
+    float minX{0.0f};
+    float minY{0.0f};
+    float maxX{0.0f};
+    float maxY{0.0f};
+
+    AABB() = default;
+    AABB(float x0, float y0, float x1, float y1) : minX(x0), minY(y0), maxX(x1), maxY(y1) {}
+
+    static AABB fromRect(float x, float y, float width, float height) {
+        return AABB{x, y, x + width, y + height};
+    }
+};
+
+// Strict overlap test (touching edges do not collide)
+inline bool aabbOverlap(const AABB& a, const AABB& b) {
+    return a.minX < b.maxX && a.maxX > b.minX &&
+           a.minY < b.maxY && a.maxY > b.minY;
+}
+
+/**
+ * @brief Swept AABB test (continuous collision)
+ *
+ * Box @p moving travels by (dx, dy) over the interval while @p target stays
+ * still (pass the displacement relative to the target when both move).
+ * Returns true when the boxes overlap at some time of the interval and
+ * writes the normalized time of impact (0 = start, 1 = end) to @p toi.
+ */
+inline bool sweptAABB(const AABB& moving, float dx, float dy, const AABB& target, float& toi) {
+    float tEnter = 0.0f;
+    float tExit = 1.0f;
+
+    // Slab test on X
+    if (dx == 0.0f) {
+        if (moving.maxX <= target.minX || moving.minX >= target.maxX) return false;
+    } else {
+        float inv = 1.0f / dx;
+        float t0 = (target.minX - moving.maxX) * inv;
+        float t1 = (target.maxX - moving.minX) * inv;
+        if (t0 > t1) { float tmp = t0; t0 = t1; t1 = tmp; }
+        if (t0 > tEnter) tEnter = t0;
+        if (t1 < tExit) tExit = t1;
+        if (tEnter >= tExit) return false;
+    }
+
+    // Slab test on Y
+    if (dy == 0.0f) {
+        if (moving.maxY <= target.minY || moving.minY >= target.maxY) return false;
+    } else {
+        float inv = 1.0f / dy;
+        float t0 = (target.minY - moving.maxY) * inv;
+        float t1 = (target.maxY - moving.minY) * inv;
+        if (t0 > t1) { float tmp = t0; t0 = t1; t1 = tmp; }
+        if (t0 > tEnter) tEnter = t0;
+        if (t1 < tExit) tExit = t1;
+        if (tEnter >= tExit) return false;
+    }
+
+    toi = tEnter;
+    return true;
+}
+
+// Bounds covering a box over its whole displacement (broadphase input for sweeps)
+inline AABB sweptBounds(const AABB& box, float dx, float dy) {
+    return AABB{
+        dx < 0.0f ? box.minX + dx : box.minX,
+        dy < 0.0f ? box.minY + dy : box.minY,
+        dx > 0.0f ? box.maxX + dx : box.maxX,
+        dy > 0.0f ? box.maxY + dy : box.maxY
+    };
+}
+
+/**
+ * @brief Packed boxes (structure of arrays) for batch narrow-phase tests
+ */
+struct AABBBatch {
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> maxX;
+    std::vector<float> maxY;
+
+    void clear() {
+        minX.clear();
+        minY.clear();
+        maxX.clear();
+        maxY.clear();
+    }
+
+    void resize(std::size_t count) {
+        minX.resize(count);
+        minY.resize(count);
+        maxX.resize(count);
+        maxY.resize(count);
+    }
+
+    void push(const AABB& box) {
+        minX.push_back(box.minX);
+        minY.push_back(box.minY);
+        maxX.push_back(box.maxX);
+        maxY.push_back(box.maxY);
+    }
+
+    void set(std::size_t i, const AABB& box) {
+        minX[i] = box.minX;
+        minY[i] = box.minY;
+        maxX[i] = box.maxX;
+        maxY[i] = box.maxY;
+    }
+
+    AABB get(std::size_t i) const { return AABB{minX[i], minY[i], maxX[i], maxY[i]}; }
+    std::size_t size() const noexcept { return minX.size(); }
+};
+
+/**
+ * @brief Batch narrow phase: one probe box against packed candidate boxes
+ *
+ * Tests @p probe against boxes [first, first + count) of the packed arrays
+ * with the same strict test as aabbOverlap(), 8 boxes per instruction with
+ * AVX, 4 with SSE, and a scalar loop otherwise (see collisionKernelName()).
+ *
+ * Bit i of @p hitMask (words of 32 bits, at least (count + 31) / 32 of them)
+ * is set when box first + i overlaps. Returns the number of overlapping boxes.
+ */
+std::size_t overlapBatch(const AABB& probe,
+                         const float* minX, const float* minY,
+                         const float* maxX, const float* maxY,
+                         std::size_t count, uint32_t* hitMask);
+
+inline std::size_t overlapBatch(const AABB& probe, const AABBBatch& boxes,
+                                std::size_t first, std::size_t count, uint32_t* hitMask) {
+    return overlapBatch(probe, boxes.minX.data() + first, boxes.minY.data() + first,
+                        boxes.maxX.data() + first, boxes.maxY.data() + first, count, hitMask);
+}
+
+// Calls fn(i) for every set bit i of a hit mask covering count boxes
+template <typename Callback>
+void forEachHit(const uint32_t* hitMask, std::size_t count, Callback&& fn) {
+    for (std::size_t w = 0; w * 32 < count; ++w) {
+        uint32_t bits = hitMask[w];
+        while (bits) {
+#if defined(__GNUC__) || defined(__clang__)
+            uint32_t bit = static_cast<uint32_t>(__builtin_ctz(bits));
+#else
+            uint32_t bit = 0;
+            while (!(bits & (1u << bit))) ++bit;
+#endif
+            fn(w * 32 + bit);
+            bits &= bits - 1;
+        }
+    }
+}
+
+// Instruction set selected at compile time for overlapBatch()
+const char* collisionKernelName();
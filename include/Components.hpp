@@ -2,6 +2,9 @@
 
 #include <cstdint>
 #include <iostream>
+#include <memory>
+
+class ColliderShape;
 
 // Basic POD components
 
@@ -59,6 +62,14 @@ struct PlayerOwner {
     explicit PlayerOwner(uint8_t pid) : playerId(pid) {}
 };
 
+// Player shot fired from a screen that was rewindTicks behind the server:
+// collisions test it against the enemies as they were that many ticks ago
+struct LagCompensation {
+    uint16_t rewindTicks{0};
+    LagCompensation() = default;
+    explicit LagCompensation(uint16_t ticks) : rewindTicks(ticks) {}
+};
+
 // Gameplay components
 
 struct Health {
@@ -88,8 +99,99 @@ struct EntityTypeTag {
     explicit EntityTypeTag(Type t) : type(t) {}
 };
 
+// Despawn after a fixed duration. The expiry is scheduled on the server timer
+// wheel when the component is added; timer holds the wheel handle so the
+// expiry can be cancelled when the entity dies earlier (0 = not scheduled).
 struct Lifetime {
-    float remaining{5.0f};  // seconds
+    float duration{5.0f};  // seconds
+    uint64_t timer{0};
     Lifetime() = default;
-    explicit Lifetime(float time) : remaining(time) {}
+    explicit Lifetime(float time) : duration(time) {}
+};
+
+// Multi-hitbox collision shape (bosses, large obstacles). The shape and its
+// BVH are built once per template and shared by every instance; when present
+// it replaces the Drawable rectangle for collisions.
+struct CompoundCollider {
+    std::shared_ptr<const ColliderShape> shape;
+    CompoundCollider() = default;
+    explicit CompoundCollider(std::shared_ptr<const ColliderShape> s) : shape(std::move(s)) {}
+};
+
+// Entity owned by an object pool (projectiles). Inactive entities keep all
+// their components but are skipped by motion, collisions and snapshots
+// until the pool hands them out again.
+struct Pooled {
+    bool active{false};
+    Pooled() = default;
+    explicit Pooled(bool a) : active(a) {}
+};
+
+// Bullet pattern fired by an enemy every interval seconds. Each volley fires
+// count bullets from the entity's center:
+//  - RADIAL: evenly spaced over the full circle, starting at angle
+//  - SPIRAL: like RADIAL, with angle advancing by spin after every volley
+//  - AIMED:  fanned over spread radians around the nearest player
+//  - HOMING: like AIMED, with bullets that keep steering towards the players
+// timer holds the next volley's handle on the server timer wheel.
+struct Emitter {
+    enum Pattern : uint8_t {
+        RADIAL = 0,
+        SPIRAL = 1,
+        AIMED = 2,
+        HOMING = 3
+    };
+    Pattern pattern{RADIAL};
+    uint8_t count{8};
+    float speed{120.0f};    // pixels per second
+    float interval{1.0f};   // seconds between volleys
+    float angle{0.0f};      // radians
+    float spin{0.0f};       // radians per volley (SPIRAL)
+    float spread{0.5f};     // radians (AIMED, HOMING)
+    uint64_t timer{0};
+    Emitter() = default;
+    Emitter(Pattern p, uint8_t c, float s, float i) : pattern(p), count(c), speed(s), interval(i) {}
+};
+
+// Analytic path: the position is origin + f(t), t being the seconds elapsed
+// since startTick. Parameters by type (see MotionCurve.hpp):
+//  - LINE:   p[0..1] velocity x, y
+//  - SINE:   p[0] velocity x, p[1] amplitude y, p[2] frequency (Hz), p[3] phase
+//  - CIRCLE: p[0..1] drift velocity x, y, p[2] radius, p[3] angular speed
+//            (rad/s), p[4] phase
+//  - BEZIER: cubic from the origin, p[0..5] control points 1..3 relative to
+//            the origin, p[6] duration (s); keeps its end velocity afterwards
+// Entities with a curve are moved by the curve system, not by Velocity, and
+// clients evaluate the same curve locally.
+struct MotionCurve {
+    enum Type : uint8_t {
+        LINE = 0,
+        SINE = 1,
+        CIRCLE = 2,
+        BEZIER = 3
+    };
+    static constexpr int TYPE_COUNT = 4;
+    static constexpr int PARAM_COUNT = 7;
+
+    Type type{LINE};
+    float originX{0.0f};
+    float originY{0.0f};
+    uint64_t startTick{0};
+    float p[PARAM_COUNT]{};
+    MotionCurve() = default;
+    MotionCurve(Type t, float x, float y) : type(t), originX(x), originY(y) {}
+};
+
+// Steers the entity's Velocity towards the nearest player, read from the
+// server's flow field: the heading turns by at most turnRate radians per
+// second and the speed is kept at speed. Used instead of a MotionCurve.
+// After duration seconds (0: never) the entity stops homing and flies off
+// to the left; timer holds that event's handle on the server timer wheel.
+struct Homing {
+    float speed{100.0f};    // pixels per second
+    float turnRate{2.0f};   // radians per second
+    float duration{0.0f};   // seconds
+    uint64_t timer{0};
+    Homing() = default;
+    Homing(float s, float t, float d = 0.0f) : speed(s), turnRate(t), duration(d) {}
 };
@@ -0,0 +1,72 @@
+#pragma once
+// EntitySet - sparse set of entities with O(1) insert / erase / contains.
+//
+// Entities are kept packed in a dense array (iteration is a plain linear walk)
+// and a sparse array indexed by entity id stores each entity's position in the
+// dense array. erase() swaps the last dense element into the hole, so removing
+// k entities costs O(k) whatever the size of the set. Iteration order is not
+// stable across erase().
+//
+// Public API:
+//  - insert(entity) -> bool   false if already present
+//  - erase(entity) -> bool    false if absent
+//  - contains(entity)
+//  - size() / empty() / clear()
+//  - begin() / end() / operator[]   over the dense array
+//
+// Don't insert or erase while iterating; collect first (the game systems
+// already gather a toDestroy list before destroying).
+#include "Entity.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class EntitySet {
+public:
+    using iterator = std::vector<Entity>::const_iterator;
+
+    bool insert(Entity entity) {
+        std::size_t id = static_cast<std::size_t>(entity);
+        if (contains(entity)) return false;
+        if (id >= _sparse.size()) _sparse.resize(id + 1, NPOS);
+        _sparse[id] = static_cast<uint32_t>(_dense.size());
+        _dense.push_back(entity);
+        return true;
+    }
+
+    bool erase(Entity entity) {
+        std::size_t id = static_cast<std::size_t>(entity);
+        if (!contains(entity)) return false;
+
+        uint32_t slot = _sparse[id];
+        Entity last = _dense.back();
+        _dense[slot] = last;
+        _sparse[static_cast<std::size_t>(last)] = slot;
+        _dense.pop_back();
+        _sparse[id] = NPOS;
+        return true;
+    }
+
+    bool contains(Entity entity) const noexcept {
+        std::size_t id = static_cast<std::size_t>(entity);
+        return id < _sparse.size() && _sparse[id] != NPOS;
+    }
+
+    void clear() {
+        for (Entity e : _dense) _sparse[static_cast<std::size_t>(e)] = NPOS;
+        _dense.clear();
+    }
+
+    std::size_t size() const noexcept { return _dense.size(); }
+    bool empty() const noexcept { return _dense.empty(); }
+
+    Entity operator[](std::size_t i) const { return _dense[i]; }
+    iterator begin() const noexcept { return _dense.begin(); }
+    iterator end() const noexcept { return _dense.end(); }
+
+private:
+    static constexpr uint32_t NPOS = 0xFFFFFFFFu;
+
+    std::vector<Entity> _dense;
+    std::vector<uint32_t> _sparse;
+};
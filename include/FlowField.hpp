@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Coarse direction grid towards the nearest target (homing)
+ *
+ * Each cell of a fixed play-area grid stores the unit direction from its
+ * center to the nearest target. build() is run once every few ticks with the
+ * current target positions (players); homing entities then only look up the
+ * cell they are in with sample(), which is O(1) whatever the number of
+ * homing entities, instead of each one searching for the nearest player.
+ *
+ * Building costs cells x targets distance tests (475 cells for the 800x600
+ * screen with 32px cells, at most four players). Points outside the play area
+ * are clamped to the border cells. Cells holding a target have no direction:
+ * sample() reports false there, as it does before the first build or when
+ * there are no targets, and callers keep their current heading.
+ */
+class FlowField {
+public:
+    struct Target {
+        float x;
+        float y;
+    };
+
+    FlowField(float originX, float originY, float width, float height, float cellSize);
+
+    void build(const std::vector<Target>& targets);
+    bool sample(float x, float y, float& dirX, float& dirY) const;
+
+    bool empty() const noexcept { return _empty; }
+    int columns() const noexcept { return _columns; }
+    int rows() const noexcept { return _rows; }
+    float cellSize() const noexcept { return _cellSize; }
+
+private:
+    int cellX(float x) const;
+    int cellY(float y) const;
+
+    float _originX;
+    float _originY;
+    float _cellSize;
+    float _invCellSize;
+    int _columns;
+    int _rows;
+    bool _empty;
+
+    // Unit direction per cell, row-major
+    std::vector<float> _dirX;
+    std::vector<float> _dirY;
+};
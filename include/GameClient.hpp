@@ -1,9 +1,14 @@
 #pragma once
 
 #include "Protocol.hpp"
+#include "MotionCurve.hpp"
+#include "SnapshotDelta.hpp"
+#include "TileMap.hpp"
 #include <asio.hpp>
+#include <chrono>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <cstdint>
 
 /**
@@ -17,6 +22,12 @@ struct ClientEntity {
     uint8_t r, g, b;
     std::string username;
 
+    // Set by ENTITY_CURVE: the position is evaluated locally from the curve
+    // instead of coming from the batch updates
+    bool onCurve{false};
+    MotionCurve curve;
+    std::chrono::steady_clock::time_point curveStart;
+
     ClientEntity() : networkId(0), x(0), y(0), width(48), height(48), health(100), r(255), g(255), b(255), username("") {}
 };
 
@@ -34,8 +45,9 @@ public:
     GameClient(const std::string& host, short tcpPort);
     ~GameClient();
 
-    // Connect to server and authenticate
-    bool connect(const std::string& username);
+    // Connect to server and authenticate. snapshotRate: world snapshots per
+    // second to ask for (0: as many as the server sends)
+    bool connect(const std::string& username, int snapshotRate = 0);
 
     // Send player input to server
     void sendInput(int8_t moveX, int8_t moveY, uint8_t buttons);
@@ -46,6 +58,11 @@ public:
     // Get all entities for rendering
     const std::unordered_map<uint32_t, ClientEntity>& getEntities() const { return _entities; }
 
+    // Terrain of the level (empty without one) and its current scroll
+    // offset: world x = map x - scroll
+    const TileMap& getTerrain() const { return _terrain; }
+    float getScroll() const;
+
     // Getters
     uint8_t getPlayerId() const { return _playerId; }
     bool isConnected() const { return _connected; }
@@ -54,8 +71,13 @@ private:
     void receiveUDP();
     void handleEntitySpawn(const char* data);
     void handleEntityUpdate(const char* data);
-    void handleEntityBatchUpdate(const char* data);
+    void handleEntityBatchUpdate(const char* data, size_t length);
+    void applySnapshot(bool complete);
     void handleEntityDestroy(const char* data);
+    void handleEntityCurve(const char* data);
+    void handleLevelScroll(const char* data);
+    void loadLevel(uint32_t levelId);
+    void advanceCurves();
 
     asio::io_context _ioContext;
     asio::ip::tcp::socket _tcpSocket;
@@ -68,12 +90,36 @@ private:
 
     uint8_t _playerId;
     uint32_t _sessionToken;
+    uint32_t _inputSequence;  // Sequence number of the next PLAYER_INPUT
+    uint32_t _snapshotTick;   // Newest snapshot rebuilt, echoed in the inputs (ack)
     bool _connected;
 
     // Entities indexed by network ID
     std::unordered_map<uint32_t, ClientEntity> _entities;
 
+    // Terrain, generated locally from the level ID. Scrolls at _scrollSpeed
+    // from _scrollAnchor, reached at _scrollStart (LEVEL_SCROLL)
+    uint32_t _levelId;
+    TileMap _terrain;
+    float _scrollAnchor;
+    float _scrollSpeed;
+    std::chrono::steady_clock::time_point _scrollStart;
+
+    // Snapshot being reassembled: the delta entries of the fragments of
+    // _assemblyTick received so far. Rebuilt from its baseline once
+    // complete; when a newer snapshot starts before the missing fragments
+    // arrive, the entities received are still applied
+    uint32_t _assemblyTick;
+    uint32_t _assemblyBaseline;
+    uint16_t _assemblyExpected;  // Fragments of that snapshot (0: none pending)
+    std::vector<bool> _assemblyFragments;
+    uint16_t _assemblyReceived;
+    std::vector<DeltaEntry> _assemblyDeltas;
+    // Complete snapshots rebuilt lately: the server's delta baselines
+    SnapshotHistory _snapshots;
+    std::vector<EntityBatchEntry> _rebuilt;
+
     // UDP receive buffer
-    char _udpBuffer[1024];
+    char _udpBuffer[MAX_DATAGRAM_SIZE];
     asio::ip::udp::endpoint _udpSenderEndpoint;
 };
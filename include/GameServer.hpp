@@ -1,14 +1,17 @@
 #pragma once
 
 #include "Server.hpp"
-#include "Registry.hpp"
-#include "Components.hpp"
-#include "HybridArray.hpp"
-#include "Entity.hpp"
+#include "Room.hpp"
+#include "WorkerPool.hpp"
+#include "TickHistogram.hpp"
 #include <thread>
 #include <atomic>
 #include <chrono>
-#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <condition_variable>
+#include <string>
 
 /**
  * @brief GameServer combines the network server with ECS game logic
@@ -16,63 +19,141 @@
  * This class runs the authoritative game simulation on the server side.
  * It manages:
  * - Network connections (via Server base functionality)
- * - ECS game world (registry, entities, components)
- * - Game loop that updates entities at fixed tick rate
- * - World state synchronization to clients
+ * - Up to MAX_ROOMS independent matches (Room: GameWorld, clients, queues),
+ *   created on demand when the TCP handshake places a player
+ * - Game loop that ticks every room at a fixed tick rate, spread over a
+ *   fixed worker pool
+ * - One sender thread doing the UDP sends of every room
+ *
+ * The simulation rate and the snapshot rate are separate: each client gets
+ * world snapshots at the rate it asked for in CONNECT, at most the server's
+ * snapshot rate, on ticks staggered against the other clients of its room.
+ *
+ * The server owns one seed (given, or drawn at startup and logged); every
+ * room derives its own from it, so a run is reproducible from that number
+ * and the recordings of its matches.
  */
 class GameServer : public Server {
 public:
-    GameServer(asio::io_context& io_context, short tcpPort, short udpPort);
+    // What the fixed-step loop does when a tick finishes after the next deadline
+    enum class OverrunPolicy {
+        CatchUp,  // run the missed ticks back to back (up to MAX_CATCH_UP_TICKS)
+        Skip      // drop the missed ticks and realign on the next deadline
+    };
+
+    GameServer(asio::io_context& io_context, short tcpPort, short udpPort,
+               int tickRate = DEFAULT_TICK_RATE,
+               OverrunPolicy overrunPolicy = OverrunPolicy::CatchUp,
+               std::size_t workerThreads = 0,
+               int snapshotRate = 0,
+               std::optional<uint64_t> seed = std::nullopt,
+               const std::string& recordDir = "",
+               std::size_t snapshotDatagram = DEFAULT_SNAPSHOT_DATAGRAM);
     ~GameServer();
 
     void startGameLoop();
     void stopGameLoop();
 
+    // Network callbacks (asio thread). They only enqueue a NetEvent in the
+    // player's room; the room applies it at the start of its next tick.
+
     // Process player input and apply to ECS
-    void handlePlayerInput(uint8_t playerId, int8_t moveX, int8_t moveY, uint8_t buttons);
+    void handlePlayerInput(const ClientInfo& client, const PlayerInputPayload& input);
 
     // Called when a client connects and is authenticated (TCP)
-    void onPlayerConnected(uint8_t playerId);
+    void onPlayerConnected(const ClientInfo& client);
 
     // Called when a client's UDP connection is ready
-    void onPlayerUdpReady(uint8_t playerId);
+    void onPlayerUdpReady(const ClientInfo& client);
 
     // Called when a client disconnects
-    void onPlayerDisconnected(uint8_t playerId);
+    void onPlayerDisconnected(const ClientInfo& client);
+
+    // Level sent in CONNECT_OK (clients generate its terrain themselves)
+    uint32_t levelId() const { return DEFAULT_LEVEL; }
+
+    // Rooms the handshake may place players in
+    std::size_t maxRooms() const { return MAX_ROOMS; }
+
+    // Snapshot rate granted to clients that ask for none (or for more)
+    int snapshotRate() const { return _snapshotRate; }
 
 private:
     // Game loop runs in separate thread
     void gameLoopThread();
-    void updateGame(float deltaTime);
-    void broadcastWorldState();
-
-    // Gameplay systems
-    void spawnBullet(uint8_t playerId, Entity playerEntity);
-    void spawnEnemy();
-    void updateLifetimes(float deltaTime);
-    void checkCollisions();
-    void destroyEntity(Entity entity);
-
-    // ECS
-    registry _registry;
-    uint32_t _nextNetworkId;
-
-    // Map player ID to entity
-    std::unordered_map<uint8_t, Entity> _playerEntities;
-    std::vector<Entity> _enemyEntities;
-    std::vector<Entity> _bulletEntities;
-
-    // Enemy spawning
-    float _enemySpawnTimer;
-    static constexpr float MIN_ENEMY_SPAWN_INTERVAL = 3.0f;
-    static constexpr float MAX_ENEMY_SPAWN_INTERVAL = 5.0f;
-    float _nextEnemySpawnTime;
+    void waitUntil(std::chrono::steady_clock::time_point deadline);
+    void logTickStats();
+    void updateGame();
+
+    // Network sender thread: sends every room's queued packets, then its
+    // latest snapshot
+    void senderThread();
+    bool wakeSender();
+
+    // Rooms (created by the asio thread, ticked by the worker pool)
+    Room& room(uint16_t roomId);
+    void pushControlEvent(Room& room, const NetEvent& event);
+
+    // Room table. Only the asio thread creates rooms: it fills the next slot,
+    // then publishes the new count (release), so the game and sender threads
+    // only ever look at fully built rooms. Rooms are never destroyed before
+    // the server; an empty room is reused for the next match.
+    std::unique_ptr<std::unique_ptr<Room>[]> _rooms;
+    std::atomic<std::size_t> _roomCount{0};
+    WorkerPool _workers;
 
     // Game loop control
     std::atomic<bool> _gameRunning;
     std::thread _gameThread;
 
-    // Tick rate (60 updates per second)
-    static constexpr int TICK_RATE = 60;
-    static constexpr float TICK_INTERVAL = 1.0f / TICK_RATE;
+    // Rooms -> sender thread. Workers never block on a socket: each room
+    // publishes at most one snapshot per tick and queues event packets, the
+    // sender thread does the encoding and the send_to calls.
+    std::atomic<bool> _senderRunning{false};
+    std::thread _senderThread;
+    std::mutex _senderMutex;
+    std::condition_variable _senderWakeup;
+    bool _senderPending{false};
+
+public:
+    // Default tick rate (60 updates per second). Collisions are swept, so
+    // lower rates (20-30 Hz) do not let fast bullets tunnel through enemies.
+    static constexpr int DEFAULT_TICK_RATE = 60;
+
+    // Level played by the server (terrain generated from this ID)
+    static constexpr uint32_t DEFAULT_LEVEL = 1;
+
+    // Matches hosted by one process (PLAYERS_PER_ROOM players each)
+    static constexpr std::size_t MAX_ROOMS = 256;
+
+    // Missed ticks replayed at most before the loop resynchronizes on the clock
+    static constexpr int MAX_CATCH_UP_TICKS = 5;
+
+private:
+    // Fixed timestep: every tick advances the world by exactly 1/_tickRate
+    // seconds, started on absolute deadlines _tickDuration apart
+    int _tickRate;
+    std::chrono::nanoseconds _tickDuration;
+    OverrunPolicy _overrunPolicy;
+    // World snapshots per second per client, at most _tickRate
+    int _snapshotRate;
+    // Root of every room's seed (drawn at startup when none is given)
+    uint64_t _seed;
+    // Directory the rooms record their matches in (empty: no recording)
+    std::string _recordDir;
+    // Size of the snapshot packets (MTU-safe by default)
+    std::size_t _snapshotDatagram;
+
+    // Last part of the wait done by spinning (sleep_until wakes up late by
+    // up to a scheduler quantum)
+    static constexpr std::chrono::microseconds SPIN_MARGIN{1500};
+    // Longest the I/O thread waits for room in a full room event queue
+    // (a running room drains it every tick)
+    static constexpr std::chrono::milliseconds CONTROL_EVENT_WAIT{100};
+    // Tick statistics logged every TICK_STATS_PERIOD seconds
+    static constexpr int TICK_STATS_PERIOD = 10;
+    TickHistogram _tickWork;   // duration of a tick of every room
+    TickHistogram _tickWake;   // lateness of the tick start vs its deadline
+    uint64_t _overruns{0};
+    uint64_t _skippedTicks{0};
 };
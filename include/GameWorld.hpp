@@ -0,0 +1,381 @@
+#pragma once
+
+#include "Registry.hpp"
+#include "Components.hpp"
+#include "HybridArray.hpp"
+#include "Entity.hpp"
+#include "EntitySet.hpp"
+#include "ProjectilePool.hpp"
+#include "SpatialHash.hpp"
+#include "Collision.hpp"
+#include "ColliderShape.hpp"
+#include "TimerWheel.hpp"
+#include "MotionCurve.hpp"
+#include "FlowField.hpp"
+#include "TileMap.hpp"
+#include "Morton.hpp"
+#include "WorkerPool.hpp"
+#include "Protocol.hpp"
+#include "Seed.hpp"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Event scheduled on the game world timer wheel
+ */
+struct GameTimer {
+    enum Kind : uint8_t {
+        ENTITY_EXPIRE = 0,  // target: entity index (Lifetime)
+        ENEMY_SPAWN = 1,    // target: unused
+        SHOT_COOLDOWN = 2,  // target: player ID
+        EMITTER_FIRE = 3,   // target: entity index (Emitter)
+        CURVE_SYNC = 4,     // target: unused (curves and level scroll)
+        FLOW_FIELD = 5,     // target: unused
+        HOMING_END = 6      // target: entity index (Homing)
+    };
+    Kind kind{ENTITY_EXPIRE};
+    uint32_t target{0};
+};
+
+/**
+ * @brief Change that clients must be told about outside of the snapshots
+ *
+ * Produced by the simulation in the order it happened (a projectile can be
+ * spawned and destroyed within the same tick) and turned into ENTITY_SPAWN /
+ * ENTITY_DESTROY / ENTITY_CURVE / ENTITY_UPDATE / LEVEL_SCROLL packets by
+ * the server.
+ */
+struct WorldEvent {
+    enum Kind : uint8_t {
+        SPAWN = 0,
+        DESTROY = 1,
+        CURVE = 2,   // the entity follows a curve (sent after its spawn, then resent periodically)
+        UPDATE = 3,  // state change of an entity left out of the snapshots (curve entities)
+        LEVEL = 4    // terrain scroll position (resent periodically)
+    };
+    Kind kind{SPAWN};
+    union {
+        EntitySpawnPayload spawn;
+        EntityDestroyPayload destroy;
+        EntityCurvePayload curve;
+        EntityUpdatePayload update;
+        LevelScrollPayload level;
+    };
+    WorldEvent() : spawn{} {}
+};
+
+/**
+ * @brief Time spent in each phase of GameWorld::tick(TickProfile&)
+ *
+ * Microseconds, summed over every tick run with the same profile. The enemy
+ * bullet pass runs inside the collision pass but is counted apart.
+ */
+struct TickProfile {
+    enum Phase {
+        TIMERS,         // Lifetimes, spawns, cooldowns, emitter volleys
+        SCROLL,
+        HOMING,
+        MOTION,
+        CURVES,
+        SPATIAL_SORT,   // Projectile storage reordered (when enabled)
+        COLLISIONS,     // Player bullets vs enemies, culls, destroys
+        ENEMY_BULLETS,  // Move, cull, hit players (parallel strips)
+        PHASE_COUNT
+    };
+    double us[PHASE_COUNT]{};
+
+    static const char* name(Phase phase);
+};
+
+/**
+ * @brief Authoritative game simulation, without any networking
+ *
+ * Owns the ECS registry and every gameplay system: timers (enemy spawns,
+ * lifetimes, shot cooldowns, emitters), homing, motion, terrain scrolling,
+ * collisions. The server feeds
+ * it player inputs and connections and reads back the per-tick events and
+ * the entity states; benchmarks drive it directly.
+ *
+ * Deterministic: the state only depends on the seed and on the calls made
+ * on the world, in order (inputs, connections, ticks); the random draws
+ * come from one stream per subsystem, all derived from the seed. A
+ * Recording of those calls replays a match exactly.
+ *
+ * Not thread-safe: everything runs on the simulation thread.
+ */
+class GameWorld {
+public:
+    // levelId selects the terrain (TileMap::generate); 0 plays without one
+    explicit GameWorld(int tickRate, bool spawnEnemies = true, uint32_t levelId = 0, uint64_t seed = 0);
+
+    // Advances the simulation by one fixed tick (1 / tickRate seconds)
+    void tick();
+    // Same tick, timing each phase into the profile (benchmarks)
+    void tick(TickProfile& profile);
+    uint64_t tickCount() const noexcept { return _timers.now(); }
+    float tickInterval() const noexcept { return _tickInterval; }
+
+    // Terrain. The level ID never changes after construction, so it may be
+    // read from any thread (the TCP handshake sends it to clients).
+    uint32_t levelId() const noexcept { return _levelId; }
+    const TileMap& terrain() const noexcept { return _terrain; }
+    float scrollX() const noexcept { return _scrollX; }
+    bool levelScroll(LevelScrollPayload& out) const;
+
+    // Players (one entity per connected player ID)
+    void spawnPlayer(uint8_t playerId, const std::string& username);
+    void removePlayer(uint8_t playerId);
+    // rewindTicks: how far behind the server the player's screen was when
+    // the input was sent; shots fired by it are checked against the enemies
+    // as they were then (clamped to LAG_COMPENSATION_WINDOW)
+    void applyPlayerInput(uint8_t playerId, int8_t moveX, int8_t moveY, uint8_t buttons,
+                          uint32_t rewindTicks = 0);
+
+    // Enemy following a curve and carrying a bullet emitter (the random
+    // spawner uses it too). The curve starts at the current tick.
+    Entity spawnEnemy(const MotionCurve& path, const Emitter& emitter);
+    // Enemy chasing the nearest player through the flow field, flying off to
+    // the left once homing.duration is over (0: chases until destroyed)
+    Entity spawnHomingEnemy(float x, float y, const Homing& homing, const Emitter& emitter);
+
+    // World sync: ENTITY_SPAWN payloads of every live entity and the curves
+    // of those that follow one; or the spawn payload of one player
+    void collectSpawns(std::vector<EntitySpawnPayload>& spawns, std::vector<EntityCurvePayload>& curves);
+    bool playerSpawn(uint8_t playerId, EntitySpawnPayload& out);
+
+    // Per-tick state of every live entity, in the ENTITY_BATCH_UPDATE layout,
+    // group by group (players, enemies, bullets, enemy bullets).
+    // Entities on a curve are left out: clients evaluate their curve.
+    void fillSnapshot(std::vector<EntityBatchEntry>& out);
+
+    // Optional pass reordering the component storage of the live projectiles
+    // by the Morton code of their position every period seconds (0, the
+    // default, turns it off), so that bullets close on screen are close in
+    // memory. The simulated state is the same with or without it (same
+    // checksum); only the entity IDs behind the network IDs change.
+    void setSpatialSortPeriod(float seconds);
+
+    // Optional pool the enemy bullet strips are simulated on once there are
+    // enough bullets (nullptr, the default: all on the calling thread). The
+    // resulting state is the same with or without it, whatever its size.
+    void setWorkerPool(WorkerPool* pool) noexcept { _workers = pool; }
+
+    // Spawns and destroys since the last clearEvents(), in order
+    const std::vector<WorldEvent>& events() const noexcept { return _events; }
+    void clearEvents() { _events.clear(); }
+
+    std::size_t enemyCount() const noexcept { return _enemyEntities.size(); }
+    std::size_t playerBulletCount() const noexcept { return _bulletEntities.size(); }
+    std::size_t enemyBulletCount() const noexcept { return _enemyBulletEntities.size(); }
+    std::size_t homingCount() const noexcept { return _homingEntities.size(); }
+
+    // Hash of the simulation state (tick, scroll, network IDs, positions,
+    // velocities and health of every live entity): equal on two worlds
+    // driven the same way from the same seed
+    uint64_t checksum();
+
+    static constexpr float WORLD_WIDTH = 800.0f;
+    static constexpr float WORLD_HEIGHT = 600.0f;
+
+private:
+    // Gameplay systems
+    static void buildPlayerBullet(registry& reg, Entity bullet);
+    static void buildEnemyBullet(registry& reg, Entity bullet);
+    void spawnBullet(uint8_t playerId, Entity playerEntity, uint32_t rewindTicks);
+    void addEnemyComponents(Entity enemy, float x, float y, float vx, float vy, const Emitter& emitter);
+    void spawnRandomEnemy();
+    MotionCurve randomPath(float x, float y);
+    void fireEmitter(Entity owner);
+    void spawnEnemyBullet(float x, float y, float angle, float speed, float turnRate = 0.0f);
+    bool nearestPlayer(float x, float y, float& targetX, float& targetY);
+    void updateTimers();
+    void onTimer(const GameTimer& timer);
+    void rebuildFlowField();
+    void updateHoming();
+    void updateMotion();
+    void advanceScroll();
+    void keepOutOfTerrain(Position& pos, float oldX, float oldY, const Drawable& draw) const;
+    bool sweepTerrain(const AABB& start, float dx, float dy, float& toi) const;
+    bool hitsTerrain(const AABB& box) const;
+    uint64_t secondsToTicks(float seconds) const;
+    void checkCollisions();
+    void checkEnemyBullets(std::vector<Entity>& toDestroy);
+    void splitBulletStrips(std::size_t count);
+    void runStrips(const WorkerPool::Job& job);
+    std::size_t bulletStrip(float y) const;
+    void destroyEntity(Entity entity);
+    void sortBySpace();
+    void sortGroupBySpace(EntitySet& group, bool stripped);
+    bool makeSpawn(Entity entity, EntitySpawnPayload& out);
+    bool makeCurve(Entity entity, EntityCurvePayload& out);
+    void emitSpawn(Entity entity);
+    void emitDestroy(uint32_t networkId);
+    void emitCurve(Entity entity);
+    void emitUpdate(Entity entity);
+    void emitLevel();
+
+    int _tickRate;
+    float _tickInterval;
+
+    // ECS
+    registry _registry;
+    uint32_t _nextNetworkId;
+
+    // Map player ID to entity, and player names for their spawn payloads
+    std::unordered_map<uint8_t, Entity> _playerEntities;
+    std::unordered_map<uint8_t, std::string> _playerNames;
+    // Category membership (O(1) insert / swap-remove)
+    EntitySet _enemyEntities;
+    EntitySet _bulletEntities;
+    EntitySet _enemyBulletEntities;
+    EntitySet _homingEntities;
+
+    // Projectiles are recycled. Player bullets: 4 players x 4 shots/s x 3s
+    // lifetime. Enemy bullets grow to the peak of the patterns on screen.
+    ProjectilePool _playerBullets;
+    ProjectilePool _enemyBullets;
+    static constexpr std::size_t PLAYER_BULLET_POOL_SIZE = 64;
+    static constexpr std::size_t ENEMY_BULLET_POOL_SIZE = 1024;
+
+    // Collision broadphase (rebuilt every tick from the enemy list).
+    // Boxes are stored at their start-of-tick position together with the
+    // displacement of the tick, so fast movers can be swept. Enemies with a
+    // CompoundCollider are inserted with their shape bounds and refined
+    // against the shape's BVH (in local space, relative to originX/originY).
+    struct EnemyCollider {
+        Entity entity;
+        uint32_t networkId;
+        AABB box;
+        float dx;
+        float dy;
+        const ColliderShape* shape;
+        float originX;
+        float originY;
+    };
+    SpatialHash _enemyGrid;
+
+    // Lag compensation: the colliders of the last ticks are kept in a ring
+    // indexed by tick, one frame per tick, the current tick's being the one
+    // the grid refers to. A lag-compensated bullet is tested against the
+    // frame its shooter saw, with the batch kernel over the frame's swept
+    // bounds (no grid for past frames: few bullets are rewound, and only
+    // enemies are stored). A past collider only counts if its entity is
+    // still the same live enemy (network ID), whose current health takes
+    // the damage.
+    struct EnemyFrame {
+        uint64_t tick{UINT64_MAX};  // Tick the frame was recorded on
+        std::vector<EnemyCollider> colliders;
+        AABBBatch bounds;            // Swept bounds, per collider
+    };
+    EnemyFrame& enemyFrame(uint64_t tick) { return _enemyHistory[tick % _enemyHistory.size()]; }
+    std::vector<EnemyFrame> _enemyHistory;
+    uint32_t _maxRewindTicks;
+    std::vector<uint32_t> _rewindHits;
+    static constexpr float LAG_COMPENSATION_WINDOW = 0.25f;  // seconds
+    // Slightly larger than the biggest regular collider (players are 48x48)
+    static constexpr float COLLISION_CELL_SIZE = 64.0f;
+
+    // Enemies on a curve, packed by curve type for the per-tick evaluation
+    CurveBatch _curves;
+    // Curves are resent to every client this often: a lost or reordered
+    // ENTITY_CURVE only freezes an enemy on screen until the next one
+    static constexpr float CURVE_SYNC_PERIOD = 1.0f;
+
+    // Scrolling terrain: a bitmap of solid tiles (no entities), in map
+    // coordinates; world x = map x - _scrollX. Bullets are destroyed on
+    // it, players can't move into it, enemies fly over it.
+    uint32_t _levelId;
+    TileMap _terrain;
+    float _scrollX;
+    static constexpr float SCROLL_SPEED = 40.0f;  // px/s
+
+    // Homing entities sample a shared direction grid towards the players,
+    // rebuilt on a timer, instead of each searching for the nearest player
+    FlowField _flowField;
+    std::vector<FlowField::Target> _flowTargets;
+    static constexpr float FLOW_FIELD_CELL_SIZE = 32.0f;
+    static constexpr float FLOW_FIELD_PERIOD = 0.1f;
+    static constexpr float HOMING_BULLET_TURN_RATE = 1.2f;  // rad/s, dodgeable
+
+    // Enemy bullets are split into horizontal strips of the play field by
+    // position, a few per pool thread. Every tick each strip moves its
+    // bullets, culls them and tests them against the players on its own,
+    // possibly on a worker: thousands of bullets against at most four
+    // players, so a strip packs its boxes and tests each player box against
+    // all of them with the batch kernel (no broadphase). Enemy bullets only
+    // collide with players, which every strip sees, so no pair spans two
+    // strips. A short serial fix-up then applies the damage and moves the
+    // bullets that crossed into another strip.
+    struct BulletStrip {
+        EntitySet bullets;
+        // Results of the last tick
+        std::vector<Entity> destroy;
+        std::vector<Entity> leaving;   // now in another strip
+        std::vector<uint32_t> damage;  // per entry of _stripPlayers
+        // Slice of the snapshot being filled
+        std::size_t snapshotFirst{0};
+        std::size_t snapshotCount{0};
+        // Scratch
+        AABBBatch boxes;
+        std::vector<Entity> order;
+        std::vector<uint32_t> hits;
+        std::vector<uint8_t> spent;
+    };
+    struct StripPlayer {
+        Entity entity;
+        AABB box;
+    };
+    void updateBulletStrip(std::size_t index);
+    std::vector<BulletStrip> _bulletStrips;
+    std::vector<StripPlayer> _stripPlayers;
+    WorkerPool* _workers;
+    // More strips than threads, since the bullets are rarely spread evenly
+    // over the screen. Serial ticks use a single strip: a strip's bullets are
+    // scattered over the component storage, so walking many strips one after
+    // the other touches every cache line several times.
+    static constexpr std::size_t STRIPS_PER_THREAD = 2;
+    // Below this the strips run on the calling thread (waking the pool costs
+    // more than it saves)
+    static constexpr std::size_t PARALLEL_MIN_BULLETS = 4096;
+    static constexpr float ENEMY_BULLET_SIZE = 8.0f;
+    // Enemy bullets further than this outside the screen are culled
+    static constexpr float ENEMY_BULLET_MARGIN = 50.0f;
+
+    // Timed behaviour (lifetimes, enemy spawns, shot cooldowns, emitters,
+    // flow field rebuilds) runs on a hierarchical timer wheel advanced once
+    // per tick: scheduling and cancelling are O(1) and a tick only visits
+    // the timers that fire.
+    TimerWheel<GameTimer> _timers;
+    std::unordered_map<uint8_t, TimerWheel<GameTimer>::handle_type> _shotCooldowns;
+
+    // Spatial sort: every _spatialSortTicks ticks (0: off), at the start of
+    // the tick. The pooled projectiles of a group keep their entity IDs;
+    // their components are moved between those IDs so that ascending IDs
+    // follow the Morton order, and their timers and sets are remapped.
+    uint64_t _spatialSortTicks;
+    std::vector<uint64_t> _sortKeys;  // Morton code << 32 | entity ID
+    std::vector<Entity> _sortFrom;
+    std::vector<Entity> _sortTo;
+    std::vector<uint8_t> _sortHoming;
+    static constexpr float SPATIAL_SORT_CELL_SIZE = 8.0f;  // Morton code quantization
+
+    // Enemy spawning. One random stream per subsystem, each seeded from the
+    // world seed: spawn times and positions, enemy kinds and their emitters,
+    // motion paths
+    enum RngStream : uint64_t { RNG_SPAWN = 0, RNG_ENEMY = 1, RNG_PATH = 2 };
+    std::mt19937 _spawnRng;
+    std::mt19937 _enemyRng;
+    std::mt19937 _pathRng;
+    static constexpr float FIRST_ENEMY_SPAWN_DELAY = 3.0f;
+    static constexpr float MIN_ENEMY_SPAWN_INTERVAL = 3.0f;
+    static constexpr float MAX_ENEMY_SPAWN_INTERVAL = 5.0f;
+    static constexpr float SHOOT_COOLDOWN = 0.25f;  // 4 shots per second max
+
+    std::vector<WorldEvent> _events;
+
+    // Set during tick(TickProfile&)
+    TickProfile* _profile{nullptr};
+};
@@ -0,0 +1,140 @@
+#pragma once
+// InputBuffer - per-player jitter buffer between the network and the simulation.
+//
+// Inputs come over UDP in bursts, late, out of order or not at all. The
+// buffer keeps them sorted by sequence number and hands the simulation
+// exactly one per tick:
+//  - duplicates and inputs older than the last one played are dropped
+//  - when the buffer runs dry the last input is played again, so a lost or
+//    late packet does not stop the player
+//  - when more than the target depth is queued the oldest inputs are
+//    skipped, so a burst does not turn into latency; their buttons are
+//    merged into the input played so a short press is not lost
+//
+// The target depth follows the measured jitter: the interarrival jitter of
+// RFC 3550 (spacing of the client timestamps against spacing of the arrival
+// ticks, smoothed over 16 packets) in ticks, times JITTER_MARGIN. Arrivals
+// are counted in ticks, not wall-clock time, so the buffer only depends on
+// which inputs reached which tick.
+//
+// Public API:
+//  - InputBuffer(tickRate)
+//  - push(input, tick)       input received before the given tick is simulated
+//  - next(out) -> bool       input for this tick; false until the first one
+//  - depth() / target() / lost() / repeated() / skipped()
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct BufferedInput {
+    uint32_t sequence{0};
+    uint32_t timestamp{0};  // Client clock (ms)
+    int8_t moveX{0};
+    int8_t moveY{0};
+    uint8_t buttons{0};
+    uint32_t snapshotTick{0};  // Passed through (lag compensation)
+};
+
+class InputBuffer {
+public:
+    explicit InputBuffer(int tickRate = 60)
+        : _tickMs(1000.0 / (tickRate > 0 ? tickRate : 60)) {}
+
+    void push(const BufferedInput& input, uint64_t tick) {
+        if (_played && !newer(input.sequence, _last.sequence)) {
+            return;  // Late or duplicate of one already played
+        }
+
+        auto it = std::lower_bound(_queue.begin(), _queue.end(), input,
+                                   [](const BufferedInput& a, const BufferedInput& b) {
+                                       return newer(b.sequence, a.sequence);
+                                   });
+        if (it != _queue.end() && it->sequence == input.sequence) {
+            return;
+        }
+        if (_queue.size() >= MAX_QUEUE) {
+            return;  // Flooding client: keep what is already queued
+        }
+        _queue.insert(it, input);
+        measureJitter(input, tick);
+    }
+
+    bool next(BufferedInput& out) {
+        if (!_played && _queue.empty()) {
+            return false;
+        }
+
+        uint8_t skippedButtons = 0;
+        uint32_t skipped = 0;
+        while (_queue.size() > _target + 1) {
+            skippedButtons |= _queue.front().buttons;
+            _queue.erase(_queue.begin());
+            ++skipped;
+        }
+        _skipped += skipped;
+
+        if (_queue.empty()) {
+            ++_repeated;
+        } else {
+            const BufferedInput& input = _queue.front();
+            if (_played) {
+                _lost += input.sequence - _last.sequence - 1 - skipped;
+            }
+            _last = input;
+            _played = true;
+            _queue.erase(_queue.begin());
+        }
+
+        out = _last;
+        out.buttons |= skippedButtons;
+        return true;
+    }
+
+    std::size_t depth() const noexcept { return _queue.size(); }
+    std::size_t target() const noexcept { return _target; }
+    uint64_t lost() const noexcept { return _lost; }          // Lost or arrived too late
+    uint64_t repeated() const noexcept { return _repeated; }  // Ticks the buffer was dry
+    uint64_t skipped() const noexcept { return _skipped; }    // Dropped to cut latency
+
+    static constexpr std::size_t MAX_DEPTH = 8;
+    static constexpr double JITTER_MARGIN = 3.0;
+
+private:
+    static bool newer(uint32_t a, uint32_t b) {
+        return static_cast<int32_t>(a - b) > 0;
+    }
+
+    void measureJitter(const BufferedInput& input, uint64_t tick) {
+        // Against the previous arrival, in arrival order: a reordered packet
+        // counts as a large deviation
+        if (_arrived) {
+            double arrivalMs = static_cast<double>(tick - _lastArrivalTick) * _tickMs;
+            double sentMs = static_cast<int32_t>(input.timestamp - _lastArrival.timestamp);
+            _jitterMs += (std::abs(arrivalMs - sentMs) - _jitterMs) / 16.0;
+            double depth = std::ceil(JITTER_MARGIN * _jitterMs / _tickMs);
+            _target = static_cast<std::size_t>(std::min(depth, static_cast<double>(MAX_DEPTH)));
+        }
+        _arrived = true;
+        _lastArrival = input;
+        _lastArrivalTick = tick;
+    }
+
+    static constexpr std::size_t MAX_QUEUE = 64;
+
+    double _tickMs;
+    std::vector<BufferedInput> _queue;  // Sorted by sequence
+    BufferedInput _last;
+    bool _played{false};
+
+    bool _arrived{false};
+    BufferedInput _lastArrival;
+    uint64_t _lastArrivalTick{0};
+    double _jitterMs{0.0};
+    std::size_t _target{0};
+
+    uint64_t _lost{0};
+    uint64_t _repeated{0};
+    uint64_t _skipped{0};
+};
@@ -0,0 +1,37 @@
+#pragma once
+// Morton (Z-order) codes for 2D positions.
+//
+// The code interleaves the bits of the quantized x and y, so sorting by it
+// keeps entities that are close on screen close in the sorted order (apart
+// from the jumps between quadrants). Used to reorder the component storage
+// of the projectiles, so that bullets close on screen are close in memory.
+//
+// Public API:
+//  - mortonInterleave(x, y)                 16-bit x and y -> 32-bit code
+//  - mortonCode(x, y, minX, minY, cellSize)  position -> code, clamped
+#include <cstdint>
+
+inline uint32_t mortonSpread(uint32_t v) {
+    v &= 0x0000FFFFu;
+    v = (v | (v << 8)) & 0x00FF00FFu;
+    v = (v | (v << 4)) & 0x0F0F0F0Fu;
+    v = (v | (v << 2)) & 0x33333333u;
+    v = (v | (v << 1)) & 0x55555555u;
+    return v;
+}
+
+inline uint32_t mortonInterleave(uint32_t x, uint32_t y) {
+    return mortonSpread(x) | (mortonSpread(y) << 1);
+}
+
+// Positions are quantized to cellSize; anything before (minX, minY) maps to
+// cell 0 and anything past 65535 cells to the last one
+inline uint32_t mortonCode(float x, float y, float minX, float minY, float cellSize) {
+    auto quantize = [cellSize](float v) -> uint32_t {
+        float q = v / cellSize;
+        if (q <= 0.0f) return 0;
+        if (q >= 65535.0f) return 65535;
+        return static_cast<uint32_t>(q);
+    };
+    return mortonInterleave(quantize(x - minX), quantize(y - minY));
+}
@@ -0,0 +1,129 @@
+#pragma once
+// MotionCurve evaluation - position = origin + f(t) for analytic enemy paths.
+//
+// The functions in namespace curves are the single definition of each curve
+// type. The server runs them over packed per-type arrays (CurveBatch), the
+// client calls evaluateCurve() for the entities it received an ENTITY_CURVE
+// for, so both sides compute the same positions from the same parameters.
+//
+// Public API:
+//  - evaluateCurve(curve, t, x, y)      one curve at t seconds
+//  - CurveBatch::add / remove / contains
+//  - CurveBatch::apply(reg, tick, dt)   every curve at the given tick
+#include "Components.hpp"
+#include "Entity.hpp"
+#include "Registry.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace curves {
+
+constexpr float TWO_PI = 6.28318530717958647692f;
+
+inline void line(float vx, float vy, float t, float& dx, float& dy) {
+    dx = vx * t;
+    dy = vy * t;
+}
+
+inline void sine(float vx, float amplitude, float frequency, float phase, float t, float& dx, float& dy) {
+    dx = vx * t;
+    dy = amplitude * std::sin(TWO_PI * frequency * t + phase);
+}
+
+inline void circle(float driftX, float driftY, float radius, float omega, float phase,
+                   float t, float& dx, float& dy) {
+    float a = omega * t + phase;
+    dx = driftX * t + radius * std::cos(a);
+    dy = driftY * t + radius * std::sin(a);
+}
+
+// Cubic Bezier from (0, 0) through (c1x, c1y), (c2x, c2y) to (ex, ey) over
+// duration seconds, then straight on at the end velocity 3 (end - c2) / duration
+inline void bezier(float c1x, float c1y, float c2x, float c2y, float ex, float ey, float duration,
+                   float t, float& dx, float& dy) {
+    float d = duration > 0.0f ? duration : 1.0f;
+    float u = std::min(t / d, 1.0f);
+    float after = std::max(t - d, 0.0f);
+    float v = 1.0f - u;
+    float b1 = 3.0f * v * v * u;
+    float b2 = 3.0f * v * u * u;
+    float b3 = u * u * u;
+    float k = 3.0f * after / d;
+    dx = b1 * c1x + b2 * c2x + b3 * ex + k * (ex - c2x);
+    dy = b1 * c1y + b2 * c2y + b3 * ey + k * (ey - c2y);
+}
+
+}  // namespace curves
+
+inline void evaluateCurve(const MotionCurve& c, float t, float& x, float& y) {
+    const float* p = c.p;
+    float dx = 0.0f;
+    float dy = 0.0f;
+    switch (c.type) {
+        case MotionCurve::LINE:
+            curves::line(p[0], p[1], t, dx, dy);
+            break;
+        case MotionCurve::SINE:
+            curves::sine(p[0], p[1], p[2], p[3], t, dx, dy);
+            break;
+        case MotionCurve::CIRCLE:
+            curves::circle(p[0], p[1], p[2], p[3], p[4], t, dx, dy);
+            break;
+        case MotionCurve::BEZIER:
+            curves::bezier(p[0], p[1], p[2], p[3], p[4], p[5], p[6], t, dx, dy);
+            break;
+    }
+    x = c.originX + dx;
+    y = c.originY + dy;
+}
+
+/**
+ * @brief Packed copy of the MotionCurve components, grouped by curve type
+ *
+ * Each curve type has its own structure-of-arrays lane, so a tick evaluates
+ * every entity of a type in one branch-free loop instead of switching on the
+ * type per entity. Curves never change after spawn: entities are added when
+ * they get their MotionCurve and removed when they die (swap-remove, O(1)).
+ */
+class CurveBatch {
+public:
+    void add(Entity entity, const MotionCurve& curve);
+    bool remove(Entity entity);
+    bool contains(Entity entity) const noexcept;
+    std::size_t size() const noexcept;
+
+    // Evaluates every curve at tick and writes Position, plus the Velocity
+    // that moved the entity there over the last tick (used by the swept
+    // collision tests)
+    void apply(registry& reg, uint64_t tick, float tickInterval);
+
+private:
+    struct Lane {
+        std::vector<Entity> entities;
+        std::vector<uint64_t> start;
+        std::vector<float> originX;
+        std::vector<float> originY;
+        std::vector<float> p[MotionCurve::PARAM_COUNT];
+        // Scratch, refilled every apply()
+        std::vector<float> t;
+        std::vector<float> x;
+        std::vector<float> y;
+
+        void push(Entity entity, const MotionCurve& curve);
+        void swapRemove(std::size_t index);
+    };
+
+    static void evaluate(Lane& lane, int type);
+
+    static constexpr uint32_t NPOS = 0xFFFFFFFFu;
+    struct Slot {
+        uint32_t lane{NPOS};
+        uint32_t index{0};
+    };
+
+    Lane _lanes[MotionCurve::TYPE_COUNT];
+    std::vector<Slot> _slots;  // by entity id
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Registry.hpp"
+#include "Components.hpp"
+#include "Entity.hpp"
+#include "EntitySet.hpp"
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Pool of pre-built projectile entities
+ *
+ * The pool creates its entities up front with every component a projectile
+ * needs (the builder adds them, the pool adds Pooled). acquire() reactivates a
+ * free entity and release() parks it again: in steady state firing and
+ * despawning only write a few fields, with no entity creation, no component
+ * insertion or removal and no storage growth.
+ *
+ * When every entity is in use, acquire() builds a new one, so the pool grows
+ * to the peak number of live projectiles and then stays there.
+ *
+ * Callers reset the per-shot state (position, velocity, owner, network ID,
+ * lifetime) after acquire(); released entities keep their stale values.
+ */
+class ProjectilePool {
+public:
+    using Builder = std::function<void(registry&, Entity)>;
+
+    ProjectilePool(registry& reg, Builder builder, std::size_t initialSize);
+
+    Entity acquire();
+    void release(Entity entity);
+
+    bool owns(Entity entity) const noexcept { return _all.contains(entity); }
+    bool isActive(Entity entity) const;
+
+    std::size_t size() const noexcept { return _all.size(); }
+    std::size_t available() const noexcept { return _free.size(); }
+
+private:
+    Entity create();
+
+    registry& _registry;
+    Builder _builder;
+    EntitySet _all;
+    std::vector<Entity> _free;
+};
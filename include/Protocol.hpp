@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <cstring>
@@ -7,7 +8,12 @@
 
 // Magic number pour identifier les paquets R-Type
 constexpr uint16_t PROTOCOL_MAGIC = 0xABCD;
-constexpr uint8_t PROTOCOL_VERSION = 0x01;
+// 0x02 : numéro de séquence dans PLAYER_INPUT
+// 0x03 : tick du snapshot dans ENTITY_BATCH_UPDATE, renvoyé dans PLAYER_INPUT
+// 0x04 : payloadSize sur 2 octets, snapshots fragmentés à la taille MTU
+// 0x05 : snapshots en delta par rapport au dernier snapshot acquitté
+// 0x06 : entrées de snapshot quantifiées et compactées au bit près
+constexpr uint8_t PROTOCOL_VERSION = 0x06;
 
 // Types de messages UDP
 enum MessageType : uint8_t {
@@ -24,6 +30,10 @@ enum MessageType : uint8_t {
     ENTITY_UPDATE = 0x21,
     ENTITY_DESTROY = 0x22,
     ENTITY_BATCH_UPDATE = 0x23,
+    ENTITY_CURVE = 0x24,
+
+    // Level (UDP - Server → Client)
+    LEVEL_SCROLL = 0x25,
 
     // Game Events (UDP)
     PLAYER_SHOOT = 0x30,
@@ -48,11 +58,11 @@ enum EntityType : uint8_t {
 // Force l'alignement sur 1 byte (pas de padding)
 #pragma pack(push, 1)
 
-// Header UDP (9 bytes)
+// Header UDP (10 bytes)
 struct PacketHeader {
     uint16_t magic;         // 0xABCD
-    uint8_t version;        // 0x01
-    uint8_t payloadSize;    // Taille du payload (0-255)
+    uint8_t version;        // PROTOCOL_VERSION
+    uint16_t payloadSize;   // Taille du payload
     uint8_t type;           // Type de message (MessageType)
     uint32_t sessionToken;  // Token d'authentification
 
@@ -60,13 +70,16 @@ struct PacketHeader {
                      payloadSize(0), type(0), sessionToken(0) {}
 };
 
-// PLAYER_INPUT Payload (8 bytes)
+// PLAYER_INPUT Payload (16 bytes)
 struct PlayerInputPayload {
     uint32_t timestamp;     // Timestamp client (ms)
     uint8_t playerId;       // ID du joueur (1-4)
     uint8_t buttons;        // Bitfield des boutons
     int8_t moveX;           // Direction horizontale (-1, 0, +1)
     int8_t moveY;           // Direction verticale (-1, 0, +1)
+    uint32_t sequence;      // Numéro de l'input, +1 à chaque envoi
+    uint32_t snapshotTick;  // Tick du dernier snapshot affiché (0 = aucun),
+                            // pour la compensation de latence des tirs
 };
 
 // Button flags
@@ -113,13 +126,85 @@ struct EntityBatchEntry {
     uint8_t health;         // Points de vie
 };
 
-// ENTITY_BATCH_UPDATE Payload (variable, max 10 entités)
-constexpr uint8_t MAX_BATCH_ENTITIES = 10;
-struct EntityBatchUpdatePayload {
-    uint8_t count;          // Nombre d'entités (1-10)
-    EntityBatchEntry entities[MAX_BATCH_ENTITIES];
+// ENTITY_CURVE Payload (45 bytes)
+// Trajectoire analytique (MotionCurve) : le client calcule lui-même la
+// position, l'entité n'apparaît plus dans les ENTITY_BATCH_UPDATE
+constexpr uint8_t CURVE_PARAM_COUNT = 7;
+struct EntityCurvePayload {
+    uint32_t networkId;     // ID réseau
+    uint8_t curveType;      // LINE=0, SINE=1, CIRCLE=2, BEZIER=3
+    float originX;          // Origine de la courbe
+    float originY;
+    float elapsed;          // Temps déjà écoulé sur la courbe (secondes)
+    float params[CURVE_PARAM_COUNT];  // Paramètres selon le type
+};
+
+// LEVEL_SCROLL Payload (12 bytes)
+// Défilement du décor : le client génère le tilemap à partir de l'ID du
+// niveau (reçu dans CONNECT_OK) et le fait défiler lui-même
+struct LevelScrollPayload {
+    uint32_t levelId;       // ID du niveau (0 = pas de décor)
+    float scrollX;          // Défilement actuel (pixels depuis le début du niveau)
+    float scrollSpeed;      // Pixels par seconde
 };
 
+// ENTITY_BATCH_UPDATE Payload (variable) : un EntityBatchHeader suivi de count
+// entrées delta compactées au bit près. Un snapshot est encodé par rapport au
+// snapshot de baselineTick, le dernier que le client a acquitté (le
+// snapshotTick de ses PLAYER_INPUT) : seules les entités modifiées, ajoutées ou
+// supprimées y figurent, une entité absente est inchangée. Il est découpé en
+// autant de fragments que nécessaire, chacun rempli jusqu'à la taille de
+// datagramme du serveur (DEFAULT_SNAPSHOT_DATAGRAM, sous la MTU d'Internet :
+// pas de fragmentation IP). Le client rassemble les fragments d'un même tick
+// avant de les appliquer. Voir SnapshotDelta.hpp.
+struct EntityBatchHeader {
+    uint32_t tick;          // Tick serveur du snapshot (identifie le snapshot)
+    uint32_t baselineTick;  // Snapshot de référence (0 : snapshot complet)
+    uint16_t fragment;      // Index du fragment (0 à fragmentCount - 1)
+    uint16_t fragmentCount; // Nombre de fragments du snapshot
+    uint16_t count;         // Nombre d'entités dans ce fragment
+};
+
+// Taille des datagrammes de snapshot (header compris), configurable sur le
+// serveur entre MIN_DATAGRAM_SIZE et MAX_DATAGRAM_SIZE ; les clients
+// reçoivent dans un buffer de MAX_DATAGRAM_SIZE
+constexpr std::size_t DEFAULT_SNAPSHOT_DATAGRAM = 1200;
+constexpr std::size_t MIN_DATAGRAM_SIZE = 128;
+constexpr std::size_t MAX_DATAGRAM_SIZE = 4096;
+
+// Entrée delta, en bits (poids faible d'abord, voir BitStream.hpp) :
+//  - écart avec le networkId de l'entrée précédente du fragment (0 pour la
+//    première), par groupes de 4 bits suivis d'un bit de continuation
+//  - flags (4 bits, DeltaFlags)
+//  - puis seulement les champs marqués dans flags, dans cet ordre :
+//    posX et posY (SNAPSHOT_POS_BITS chacun), health (SNAPSHOT_HEALTH_BITS)
+// Le fragment est complété par des zéros jusqu'à l'octet suivant.
+enum DeltaFlags : uint8_t {
+    DELTA_POS_X = 0x01,
+    DELTA_POS_Y = 0x02,
+    DELTA_HEALTH = 0x04,
+    DELTA_REMOVED = 0x08    // Entité absente du nouveau snapshot (aucun champ)
+};
+constexpr unsigned DELTA_FLAG_BITS = 4;
+
+// Quantification des positions : pas de 1/8 de pixel sur 13 bits, soit
+// 1024 pixels à partir de SNAPSHOT_MIN_X / SNAPSHOT_MIN_Y (l'écran 800x600
+// et les marges où les entités apparaissent et disparaissent ; au-delà la
+// position est ramenée au bord). Health sur 7 bits (0-127).
+constexpr float SNAPSHOT_POS_STEP = 0.125f;
+constexpr unsigned SNAPSHOT_POS_BITS = 13;
+constexpr float SNAPSHOT_MIN_X = -112.0f;
+constexpr float SNAPSHOT_MIN_Y = -212.0f;
+constexpr unsigned SNAPSHOT_HEALTH_BITS = 7;
+
+// Entrée la plus longue : écart sur 40 bits, flags, tous les champs
+constexpr std::size_t MAX_DELTA_ENTRY_BITS = 40 + DELTA_FLAG_BITS + 2 * SNAPSHOT_POS_BITS + SNAPSHOT_HEALTH_BITS;
+
+// Entités par fragment pour une taille de datagramme, au pire
+inline std::size_t batchEntitiesPerDatagram(std::size_t datagramSize) {
+    return (datagramSize - sizeof(PacketHeader) - sizeof(EntityBatchHeader)) * 8 / MAX_DELTA_ENTRY_BITS;
+}
+
 #pragma pack(pop)
 
 // Utilitaires pour le protocole TCP (texte)
@@ -0,0 +1,115 @@
+#pragma once
+// Recording - binary log of everything that drives a GameWorld.
+//
+// A world is deterministic (see GameWorld): its state only depends on its
+// parameters (tick rate, level, seed) and on the calls made on it, in
+// order. The room records those calls as they reach the world, after the
+// jitter buffer and the lag measurement, so a replay does not depend on
+// when packets arrived. Replaying a recording on the same build gives the
+// same state bit for bit; the CHECKSUM records let the replay check it.
+//
+// File layout (little-endian, packed): a RecordingHeader, then records made
+// of a type byte and the fields of that type:
+//  - TICK                                      world.tick()
+//  - CONNECT    playerId, username[16]         world.spawnPlayer()
+//  - DISCONNECT playerId                       world.removePlayer()
+//  - INPUT      playerId, moveX, moveY, buttons, rewindTicks
+//                                              world.applyPlayerInput()
+//  - REPEAT     playerId                       same INPUT as that player's last
+//  - CHECKSUM   uint64 world.checksum() after the last TICK
+// An input identical to the player's previous one (same keys, same lag) is
+// a 2-byte REPEAT; at worst a tick of 4 players takes 25 bytes, 90 KB per
+// minute at 60 Hz.
+//
+// Public API:
+//  - RecordingWriter(path, header) / ok() / connect() / disconnect() /
+//    input() / tick() / checksum()
+//  - RecordingReader(path) / ok() / header() / next(event) -> bool /
+//    truncated()                               REPEATs come out as INPUTs
+//  - applyRecordedEvent(world, event)          replays one event
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+class GameWorld;
+
+#pragma pack(push, 1)
+struct RecordingHeader {
+    char magic[4]{'R', 'T', 'R', 'C'};
+    uint16_t version{1};
+    uint16_t tickRate{60};
+    uint32_t levelId{0};
+    uint64_t seed{0};
+};
+#pragma pack(pop)
+
+struct RecordedEvent {
+    enum Type : uint8_t {
+        TICK = 0,
+        CONNECT = 1,
+        DISCONNECT = 2,
+        INPUT = 3,
+        REPEAT = 4,
+        CHECKSUM = 5
+    };
+    Type type{TICK};
+    uint8_t playerId{0};
+    int8_t moveX{0};
+    int8_t moveY{0};
+    uint8_t buttons{0};
+    uint8_t rewindTicks{0};
+    char username[16]{};
+    uint64_t checksum{0};
+};
+
+class RecordingWriter {
+public:
+    RecordingWriter(const std::string& path, const RecordingHeader& header);
+
+    bool ok() const { return static_cast<bool>(_out); }
+
+    void connect(uint8_t playerId, const char* username);
+    void disconnect(uint8_t playerId);
+    // Rewinds beyond 255 ticks are recorded as 255 (the world clamps them
+    // to far less)
+    void input(uint8_t playerId, int8_t moveX, int8_t moveY, uint8_t buttons, uint32_t rewindTicks);
+    void tick();
+    // Also flushes the file, so a killed server loses at most the events
+    // since the last checksum
+    void checksum(uint64_t value);
+
+private:
+    struct LastInput {
+        bool valid{false};
+        int8_t moveX{0};
+        int8_t moveY{0};
+        uint8_t buttons{0};
+        uint8_t rewindTicks{0};
+    };
+
+    std::ofstream _out;
+    LastInput _last[256];
+};
+
+class RecordingReader {
+public:
+    explicit RecordingReader(const std::string& path);
+
+    // False when the file can't be read or is not a recording
+    bool ok() const { return _ok; }
+    const RecordingHeader& header() const { return _header; }
+
+    // False at the end of the file, or on a truncated or unknown record
+    bool next(RecordedEvent& event);
+    bool truncated() const { return _truncated; }
+
+private:
+    std::ifstream _in;
+    RecordingHeader _header;
+    bool _ok{false};
+    bool _truncated{false};
+    RecordedEvent _last[256];
+};
+
+// CHECKSUM events are not applied: compare them to world.checksum()
+void applyRecordedEvent(GameWorld& world, const RecordedEvent& event);
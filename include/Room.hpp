@@ -0,0 +1,175 @@
+#pragma once
+
+#include "GameWorld.hpp"
+#include "InputBuffer.hpp"
+#include "Recording.hpp"
+#include "SnapshotDelta.hpp"
+#include "SpscQueue.hpp"
+#include "TripleBuffer.hpp"
+#include "WorkerPool.hpp"
+#include "WorldSnapshot.hpp"
+#include <asio.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Network event handed from the asio thread to a room's simulation
+ */
+struct NetEvent {
+    enum Type : uint8_t {
+        INPUT = 0,
+        CONNECT = 1,     // TCP authenticated: spawn the player entity
+        UDP_READY = 2,   // First UDP packet received: send the world to the player
+        DISCONNECT = 3
+    };
+    Type type{INPUT};
+    uint8_t playerId{0};
+    int8_t moveX{0};
+    int8_t moveY{0};
+    uint8_t buttons{0};
+    uint32_t sequence{0};               // INPUT
+    uint32_t timestamp{0};              // INPUT: client clock (ms)
+    uint32_t snapshotTick{0};           // INPUT: last snapshot the client had (0: none)
+    uint8_t snapshotRate{0};            // CONNECT: snapshots per second (0: every tick)
+    asio::ip::udp::endpoint endpoint;   // UDP_READY
+    char username[16]{};                // CONNECT (same size as EntitySpawnPayload::username)
+};
+
+/**
+ * @brief One match: a GameWorld, the clients playing in it and its queues
+ *
+ * Rooms are independent: each has its own world (registry, network IDs,
+ * player IDs 1-4), its own event queue from the asio thread and its own
+ * packet queue and snapshot buffer to the sender thread. GameServer ticks
+ * them on a worker pool; a room is only ever ticked by one worker at a time.
+ *
+ * Inputs go through a per-player jitter buffer (InputBuffer): every tick the
+ * room applies exactly one input per player, in one pass before the world
+ * tick, however the packets arrived.
+ *
+ * Each client receives a snapshot every few ticks (its snapshot rate), on a
+ * tick offset chosen so that the clients of a room are spread over the ticks
+ * instead of all being sent to on the same one. Ticks where no client is due
+ * publish no snapshot at all. A snapshot goes out as fragments filled up to
+ * the datagram size, the client puts them back together. It is encoded per
+ * client as a delta against the newest snapshot that client acknowledged
+ * (the snapshot tick echoed in its inputs), so only what changed since is
+ * sent; clients acknowledging the same snapshot share one encoding.
+ *
+ * A room without clients is not simulated. When its last client leaves the
+ * world is rebuilt, so the next match starts from a fresh level.
+ *
+ * Every match gets its own world seed, derived from the room seed and the
+ * match number. With a record directory, each match is recorded there
+ * (room<id>_match<n>.rec, see Recording.hpp) as the world sees it, and can
+ * be replayed offline with r-type_replay.
+ *
+ * The world splits its enemy bullets over the same pool. While several rooms
+ * are ticked in parallel that inner split runs on the room's worker; a room
+ * ticked alone gets every pool thread.
+ */
+class Room {
+public:
+    // wakeSender is called when the packet queue is full; it returns false
+    // once the sender thread is stopped. The packet is dropped then, or when
+    // the queue stays full for OUTGOING_QUEUE_WAIT.
+    // recordDir: where matches are recorded (empty: not recorded).
+    // snapshotDatagram: size of the snapshot packets, header included.
+    Room(uint16_t id, int tickRate, uint32_t levelId, uint64_t seed, const std::string& recordDir,
+         std::size_t snapshotDatagram, WorkerPool* workers, std::function<bool()> wakeSender);
+
+    uint16_t id() const noexcept { return _id; }
+
+    // asio thread. Inputs are dropped when the queue is full (they are resent
+    // every client frame); the caller retries control events.
+    void pushInput(const NetEvent& event);
+    bool tryPush(const NetEvent& event) { return _netEvents.try_push(event); }
+
+    // Worker thread: applies the queued events and one input per player,
+    // advances the world by one tick, queues its spawn/destroy packets and
+    // publishes its snapshot
+    void tick();
+
+    // Sender thread: queued packets first, then the latest snapshot
+    void send(asio::ip::udp::socket& socket);
+
+    // Simulation side (read between ticks)
+    std::size_t clientCount() const noexcept { return _clients.size(); }
+
+private:
+    void startMatch();
+    void drainNetEvents();
+    void applyInputs();
+    void connectPlayer(uint8_t playerId, const char* username, int snapshotRate);
+    void sendWorldToPlayer(uint8_t playerId, const asio::ip::udp::endpoint& endpoint);
+    void removePlayer(uint8_t playerId);
+    void flushWorldEvents();
+    void publishSnapshot();
+    void sendToAllClients(std::vector<char> packet);
+    void sendToClient(std::vector<char> packet, const asio::ip::udp::endpoint& endpoint);
+    void queuePacket(OutgoingPacket&& packet);
+    void sendSnapshot(asio::ip::udp::socket& socket, const WorldSnapshot& snapshot);
+
+    uint16_t _id;
+    int _tickRate;
+    uint32_t _levelId;
+    std::size_t _snapshotDatagram;
+    WorkerPool* _workers;
+    std::function<bool()> _wakeSender;
+
+    // Simulation (owned by whichever worker ticks the room)
+    std::unique_ptr<GameWorld> _world;
+    uint64_t _seed;
+    uint64_t _match{0};
+    uint64_t _matchSeed{0};
+    // Recording of the current match, opened on its first connection
+    std::string _recordDir;
+    std::unique_ptr<RecordingWriter> _recording;
+
+    // asio thread -> simulation. Single producer: every Server callback runs
+    // on the io_context thread.
+    SpscQueue<NetEvent> _netEvents;
+    std::atomic<uint64_t> _droppedInputs{0};
+    static constexpr std::size_t NET_EVENT_QUEUE_CAPACITY = 1024;
+
+    // Simulation's own view of the clients, so workers never read the
+    // sessions owned by the network thread
+    struct SimClient {
+        asio::ip::udp::endpoint endpoint;
+        bool udpReady{false};
+        // Sent a snapshot on the ticks where tick % sendInterval == sendPhase
+        uint64_t sendInterval{1};
+        uint64_t sendPhase{0};
+        // Newest snapshot the client acknowledged (delta baseline)
+        uint32_t ackTick{0};
+        InputBuffer inputs;
+    };
+    uint64_t leastBusyPhase(uint64_t interval) const;
+    std::unordered_map<uint8_t, SimClient> _clients;
+
+    // Simulation -> sender thread: the snapshot of every tick where a client
+    // is due one, event packets in tick order
+    TripleBuffer<WorldSnapshot> _snapshots;
+    // Simulation side: who the last published snapshot was for
+    std::vector<asio::ip::udp::endpoint> _lastRecipients;
+    SpscQueue<OutgoingPacket> _outgoing;
+    static constexpr std::size_t OUTGOING_QUEUE_CAPACITY = 4096;
+    // How long a full queue may hold up the worker before the packet is
+    // dropped (the sender is then stuck, not just late)
+    static constexpr std::chrono::milliseconds OUTGOING_QUEUE_WAIT{5};
+    uint64_t _droppedPackets{0};
+    // Sender thread: the snapshots sent lately (quantized, sorted by network
+    // ID), the delta being sent and where its fragments start
+    SnapshotHistory _sentSnapshots;
+    std::vector<DeltaEntry> _deltaEntries;
+    std::vector<std::size_t> _fragmentStarts;
+    std::vector<char> _snapshotPacket;
+    uint64_t _broadcastCount{0};
+    uint64_t _lastBroadcastLog{0};  // second of simulation
+};
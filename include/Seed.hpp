@@ -0,0 +1,25 @@
+#pragma once
+// Seed - derives independent random seeds from one (splitmix64).
+//
+// The server picks one seed; every room, every match of a room and every
+// random stream of a world gets its own seed derived from it, so a stream
+// drawing more or fewer numbers never shifts another, and one number is
+// enough to reproduce a whole run.
+//
+// Public API:
+//  - deriveSeed(seed, stream) -> uint64_t   seed of sub-stream `stream`
+//  - randomSeed() -> uint64_t               from std::random_device
+#include <cstdint>
+#include <random>
+
+inline uint64_t deriveSeed(uint64_t seed, uint64_t stream) {
+    uint64_t z = seed + (stream + 1) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+inline uint64_t randomSeed() {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) | device();
+}
@@ -10,13 +10,15 @@
 
 // Informations d'un client connecté
 struct ClientInfo {
-    uint8_t playerId;                          // ID du joueur (1-4)
+    uint16_t roomId;                           // Partie dans laquelle le joueur est placé
+    uint8_t playerId;                          // ID du joueur dans sa partie (1-4, 0 : pas encore placé)
     uint32_t sessionToken;                     // Token d'authentification UDP
     std::string username;                      // Nom du joueur
     asio::ip::udp::endpoint udpEndpoint;       // Endpoint UDP du client
     bool udpInitialized;                       // Premier paquet UDP reçu ?
+    int snapshotRate;                          // Snapshots par seconde accordés (0 : un par tick)
 
-    ClientInfo() : playerId(0), sessionToken(0), udpInitialized(false) {}
+    ClientInfo() : roomId(0), playerId(0), sessionToken(0), udpInitialized(false), snapshotRate(0) {}
 };
 
 class Session : public std::enable_shared_from_this<Session> {
@@ -53,27 +55,46 @@ public:
     short getUdpPort() const { return _udpPort; }
     size_t getClientCount() const { return _sessions.size(); }
     void broadcastMessage(const std::string& message, int excludeClientId = -1);
+    void broadcastToRoom(uint16_t roomId, const std::string& message, int excludeClientId = -1);
     void removeSession(int clientId);
 
-    // Virtual methods for subclasses to override
-    virtual void handlePlayerInput(uint8_t playerId, int8_t moveX, int8_t moveY, uint8_t buttons) {
-        (void)playerId; (void)moveX; (void)moveY; (void)buttons;
+    // Place une session authentifiée dans une partie : remplit roomId,
+    // playerId et sessionToken. Faux si toutes les parties sont pleines.
+    bool joinRoom(const std::shared_ptr<Session>& session);
+
+    // Virtual methods for subclasses to override. The ClientInfo identifies
+    // the player (room + room-local player ID).
+    virtual void handlePlayerInput(const ClientInfo& client, const PlayerInputPayload& input) {
+        (void)client; (void)input;
     }
-    virtual void onPlayerConnected(uint8_t playerId) { (void)playerId; }
-    virtual void onPlayerDisconnected(uint8_t playerId) { (void)playerId; }
-    virtual void onPlayerUdpReady(uint8_t playerId) { (void)playerId; }
+    virtual void onPlayerConnected(const ClientInfo& client) { (void)client; }
+    virtual void onPlayerDisconnected(const ClientInfo& client) { (void)client; }
+    virtual void onPlayerUdpReady(const ClientInfo& client) { (void)client; }
+    // Level announced in CONNECT_OK (0: no level)
+    virtual uint32_t levelId() const { return 0; }
+    // Number of rooms players can be placed in
+    virtual std::size_t maxRooms() const { return 1; }
+    // Highest snapshot rate a client may ask for in CONNECT (0: not negotiated)
+    virtual int snapshotRate() const { return 0; }
+
+    static constexpr std::size_t PLAYERS_PER_ROOM = 4;
 
 protected:
     void doAccept();
     void doReceiveUDP();
     void handleUDPPacket(const char* data, size_t length,
                          const asio::ip::udp::endpoint& senderEndpoint);
+    void leaveRoom(ClientInfo& info);
 
     asio::io_context& _ioContext;
     asio::ip::tcp::acceptor _acceptor;
     asio::ip::udp::socket _udpSocket;
     short _udpPort;
     std::vector<std::shared_ptr<Session>> _sessions;
+    // Routage UDP : token de session -> session (une recherche par paquet)
+    std::unordered_map<uint32_t, std::shared_ptr<Session>> _sessionsByToken;
+    // Player IDs pris dans chaque partie (bit i : player ID i + 1)
+    std::vector<uint8_t> _roomSlots;
     int _nextClientId;
     std::mt19937 _randomGenerator;
 
@@ -0,0 +1,198 @@
+#pragma once
+// SnapshotDelta - encodes a snapshot as the changes since an older one.
+//
+// Both sides keep the last snapshots they sent or rebuilt (SnapshotHistory),
+// sorted by network ID. The server encodes a new snapshot against the one
+// the client last acknowledged: an entry per entity whose position or health
+// changed (only the changed fields), per new entity (every field) and per
+// entity gone since (DELTA_REMOVED). Unchanged entities are not sent at all.
+// An empty baseline gives a full snapshot. The client merges the entries
+// with its copy of the same baseline and gets the new snapshot bit for bit.
+//
+// Entries are bit-packed (layout: see DeltaFlags in Protocol.hpp): network
+// IDs as the gap from the previous entry, positions in 1/8 pixel fixed
+// point, health in 7 bits; a moving entity takes about 35 bits instead of
+// 13 bytes. The server snaps its snapshots to that precision before storing
+// and comparing them (quantizeSnapshot), so what the client rebuilds is
+// exactly what the server diffs against. The gaps restart at every fragment,
+// which can be decoded on its own.
+//
+// Public API:
+//  - quantizeSnapshot(entities)   snaps to the precision of the wire
+//  - sortByNetworkId(entities)
+//  - diffSnapshots(baseline, current, out)
+//                                 delta entries, sorted by network ID
+//  - deltaEntryBits(entry, previousId) / writeDeltaEntry(writer, entry,
+//    previousId)                  previousId: 0 for a fragment's first entry
+//  - readSnapshotDelta(data, size, count, out) -> bool
+//                                 false on a malformed fragment
+//  - applySnapshotDelta(baseline, deltas, out)
+//                                 deltas sorted by network ID
+//  - SnapshotHistory: store(tick) -> vector& / find(tick) -> const vector*
+#include "BitStream.hpp"
+#include "Protocol.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+struct DeltaEntry {
+    EntityBatchEntry state;     // Fields not in flags are left at 0
+    uint8_t flags{0};
+};
+
+constexpr Quantizer SNAPSHOT_X{SNAPSHOT_MIN_X, SNAPSHOT_POS_STEP, SNAPSHOT_POS_BITS};
+constexpr Quantizer SNAPSHOT_Y{SNAPSHOT_MIN_Y, SNAPSHOT_POS_STEP, SNAPSHOT_POS_BITS};
+constexpr Quantizer SNAPSHOT_HEALTH{0.0f, 1.0f, SNAPSHOT_HEALTH_BITS};
+
+inline void quantizeSnapshot(std::vector<EntityBatchEntry>& entities) {
+    for (EntityBatchEntry& entry : entities) {
+        entry.posX = SNAPSHOT_X.snap(entry.posX);
+        entry.posY = SNAPSHOT_Y.snap(entry.posY);
+        entry.health = static_cast<uint8_t>(SNAPSHOT_HEALTH.quantize(entry.health));
+    }
+}
+
+inline void sortByNetworkId(std::vector<EntityBatchEntry>& entities) {
+    std::sort(entities.begin(), entities.end(),
+              [](const EntityBatchEntry& a, const EntityBatchEntry& b) { return a.networkId < b.networkId; });
+}
+
+inline void diffSnapshots(const std::vector<EntityBatchEntry>& baseline,
+                          const std::vector<EntityBatchEntry>& current, std::vector<DeltaEntry>& out) {
+    const uint8_t all = DELTA_POS_X | DELTA_POS_Y | DELTA_HEALTH;
+    auto removed = [&out](const EntityBatchEntry& gone) {
+        DeltaEntry delta{};
+        delta.state.networkId = gone.networkId;
+        delta.flags = DELTA_REMOVED;
+        out.push_back(delta);
+    };
+
+    // Merge of the two sorted lists. Positions are compared bit for bit:
+    // the client must rebuild exactly what the server stored.
+    std::size_t b = 0;
+    for (const EntityBatchEntry& now : current) {
+        while (b < baseline.size() && baseline[b].networkId < now.networkId) {
+            removed(baseline[b++]);
+        }
+        if (b == baseline.size() || baseline[b].networkId != now.networkId) {
+            out.push_back(DeltaEntry{now, all});
+            continue;
+        }
+        const EntityBatchEntry& before = baseline[b++];
+        uint8_t flags = 0;
+        if (std::memcmp(&before.posX, &now.posX, sizeof(now.posX)) != 0) flags |= DELTA_POS_X;
+        if (std::memcmp(&before.posY, &now.posY, sizeof(now.posY)) != 0) flags |= DELTA_POS_Y;
+        if (before.health != now.health) flags |= DELTA_HEALTH;
+        if (flags != 0) {
+            out.push_back(DeltaEntry{now, flags});
+        }
+    }
+    while (b < baseline.size()) {
+        removed(baseline[b++]);
+    }
+}
+
+inline std::size_t deltaEntryBits(const DeltaEntry& delta, uint32_t previousId) {
+    std::size_t bits = varUintBits(delta.state.networkId - previousId) + DELTA_FLAG_BITS;
+    if (delta.flags & DELTA_POS_X) bits += SNAPSHOT_POS_BITS;
+    if (delta.flags & DELTA_POS_Y) bits += SNAPSHOT_POS_BITS;
+    if (delta.flags & DELTA_HEALTH) bits += SNAPSHOT_HEALTH_BITS;
+    return bits;
+}
+
+inline void writeDeltaEntry(BitWriter& writer, const DeltaEntry& delta, uint32_t previousId) {
+    writer.writeVarUint(delta.state.networkId - previousId);
+    writer.write(delta.flags, DELTA_FLAG_BITS);
+    if (delta.flags & DELTA_POS_X) writer.write(SNAPSHOT_X.quantize(delta.state.posX), SNAPSHOT_POS_BITS);
+    if (delta.flags & DELTA_POS_Y) writer.write(SNAPSHOT_Y.quantize(delta.state.posY), SNAPSHOT_POS_BITS);
+    if (delta.flags & DELTA_HEALTH) writer.write(SNAPSHOT_HEALTH.quantize(delta.state.health), SNAPSHOT_HEALTH_BITS);
+}
+
+inline bool readSnapshotDelta(const char* data, std::size_t size, std::size_t count,
+                              std::vector<DeltaEntry>& out) {
+    BitReader reader(data, size);
+    uint32_t previousId = 0;
+    for (std::size_t i = 0; i < count && reader.ok(); ++i) {
+        DeltaEntry delta{};
+        delta.state.networkId = previousId + reader.readVarUint();
+        delta.flags = static_cast<uint8_t>(reader.read(DELTA_FLAG_BITS));
+        if (delta.flags & DELTA_POS_X) delta.state.posX = SNAPSHOT_X.dequantize(reader.read(SNAPSHOT_POS_BITS));
+        if (delta.flags & DELTA_POS_Y) delta.state.posY = SNAPSHOT_Y.dequantize(reader.read(SNAPSHOT_POS_BITS));
+        if (delta.flags & DELTA_HEALTH) {
+            delta.state.health = static_cast<uint8_t>(reader.read(SNAPSHOT_HEALTH_BITS));
+        }
+        previousId = delta.state.networkId;
+        out.push_back(delta);
+    }
+    // Only the padding of the last byte may be left
+    return reader.ok() && reader.remainingBits() < 8;
+}
+
+inline void applySnapshotDelta(const std::vector<EntityBatchEntry>& baseline,
+                               const std::vector<DeltaEntry>& deltas, std::vector<EntityBatchEntry>& out) {
+    out.clear();
+    std::size_t d = 0;
+    for (const EntityBatchEntry& before : baseline) {
+        for (; d < deltas.size() && deltas[d].state.networkId < before.networkId; ++d) {
+            if (!(deltas[d].flags & DELTA_REMOVED)) out.push_back(deltas[d].state);  // New entity
+        }
+        if (d == deltas.size() || deltas[d].state.networkId != before.networkId) {
+            out.push_back(before);  // Unchanged
+            continue;
+        }
+        const DeltaEntry& delta = deltas[d++];
+        if (delta.flags & DELTA_REMOVED) continue;
+        EntityBatchEntry now = before;
+        if (delta.flags & DELTA_POS_X) now.posX = delta.state.posX;
+        if (delta.flags & DELTA_POS_Y) now.posY = delta.state.posY;
+        if (delta.flags & DELTA_HEALTH) now.health = delta.state.health;
+        out.push_back(now);
+    }
+    for (; d < deltas.size(); ++d) {
+        if (!(deltas[d].flags & DELTA_REMOVED)) out.push_back(deltas[d].state);
+    }
+}
+
+/**
+ * @brief The last few snapshots, by tick, for use as delta baselines
+ *
+ * A fixed ring: storing a snapshot reuses the vector of the oldest one, so
+ * it allocates nothing once warm. Tick 0 is never stored (it means "no
+ * baseline" on the wire). Storing a tick again (ticks restart with every
+ * match) forgets the older snapshot of that tick.
+ */
+class SnapshotHistory {
+public:
+    // Covers about half a second of acknowledgement delay at 60 Hz
+    static constexpr std::size_t CAPACITY = 32;
+
+    // Slot for a new snapshot; the caller fills it
+    std::vector<EntityBatchEntry>& store(uint32_t tick) {
+        for (Slot& old : _slots) {
+            if (old.tick == tick) old.tick = 0;
+        }
+        Slot& slot = _slots[_next];
+        _next = (_next + 1) % CAPACITY;
+        slot.tick = tick;
+        slot.entities.clear();
+        return slot.entities;
+    }
+
+    const std::vector<EntityBatchEntry>* find(uint32_t tick) const {
+        if (tick == 0) return nullptr;
+        for (const Slot& slot : _slots) {
+            if (slot.tick == tick) return &slot.entities;
+        }
+        return nullptr;
+    }
+
+private:
+    struct Slot {
+        uint32_t tick{0};
+        std::vector<EntityBatchEntry> entities;
+    };
+    Slot _slots[CAPACITY];
+    std::size_t _next{0};
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Collision.hpp"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Uniform grid broadphase over a fixed play area
+ *
+ * The grid is rebuilt every tick: callers clear() it, insert() one box per
+ * collider with a caller-defined id (typically an index into a packed array),
+ * then build() sorts the entries into cells (counting sort, no per-cell
+ * allocations). query() reports every id whose cells overlap the query box.
+ *
+ * Boxes outside the play area are clamped to the border cells, so entities
+ * spawning just off-screen are still found.
+ *
+ * Each candidate is reported exactly once per query even when both boxes
+ * span several cells: a pair is only reported from the first cell the two
+ * cell ranges have in common. query() does not mutate the grid, so several
+ * threads may query a built grid concurrently.
+ *
+ * query() only reports candidates and leaves the narrow phase to the
+ * caller. queryOverlaps() also runs the batch AABB kernel (overlapBatch) on
+ * each cell: boxes are stored contiguously per cell, so no gathering is
+ * needed, and only ids whose stored box overlaps the query box are reported.
+ */
+class SpatialHash {
+public:
+    SpatialHash(float originX, float originY, float width, float height, float cellSize);
+
+    void clear();
+    void insert(uint32_t id, const AABB& box);
+    void build();
+
+    template <typename Callback>
+    void query(const AABB& box, Callback&& callback) const {
+        const CellRange q = cellRange(box);
+        for (int cy = q.y0; cy <= q.y1; ++cy) {
+            for (int cx = q.x0; cx <= q.x1; ++cx) {
+                const std::size_t cell = static_cast<std::size_t>(cy) * _columns + cx;
+                for (uint32_t k = _cellStart[cell]; k < _cellStart[cell + 1]; ++k) {
+                    const Entry& e = _entries[_cellEntries[k]];
+                    // Report the pair only from the first shared cell
+                    const int firstX = e.range.x0 > q.x0 ? e.range.x0 : q.x0;
+                    const int firstY = e.range.y0 > q.y0 ? e.range.y0 : q.y0;
+                    if (cx == firstX && cy == firstY) {
+                        callback(e.id);
+                    }
+                }
+            }
+        }
+    }
+
+    template <typename Callback>
+    void queryOverlaps(const AABB& box, Callback&& callback) const {
+        constexpr std::size_t CHUNK = 64;
+        uint32_t hitMask[CHUNK / 32];
+
+        const CellRange q = cellRange(box);
+        for (int cy = q.y0; cy <= q.y1; ++cy) {
+            for (int cx = q.x0; cx <= q.x1; ++cx) {
+                const std::size_t cell = static_cast<std::size_t>(cy) * _columns + cx;
+                const std::size_t begin = _cellStart[cell];
+                const std::size_t end = _cellStart[cell + 1];
+                for (std::size_t first = begin; first < end; first += CHUNK) {
+                    const std::size_t count = end - first < CHUNK ? end - first : CHUNK;
+                    if (overlapBatch(box, _cellBoxes, first, count, hitMask) == 0) continue;
+                    forEachHit(hitMask, count, [&](std::size_t i) {
+                        const Entry& e = _entries[_cellEntries[first + i]];
+                        const int firstX = e.range.x0 > q.x0 ? e.range.x0 : q.x0;
+                        const int firstY = e.range.y0 > q.y0 ? e.range.y0 : q.y0;
+                        if (cx == firstX && cy == firstY) {
+                            callback(e.id);
+                        }
+                    });
+                }
+            }
+        }
+    }
+
+    std::size_t size() const noexcept { return _entries.size(); }
+    int columns() const noexcept { return _columns; }
+    int rows() const noexcept { return _rows; }
+    float cellSize() const noexcept { return _cellSize; }
+
+private:
+    struct CellRange {
+        int x0, y0, x1, y1;
+    };
+
+    struct Entry {
+        uint32_t id;
+        CellRange range;
+        AABB box;
+    };
+
+    CellRange cellRange(const AABB& box) const;
+    int cellX(float x) const;
+    int cellY(float y) const;
+
+    float _originX;
+    float _originY;
+    float _cellSize;
+    float _invCellSize;
+    int _columns;
+    int _rows;
+
+    std::vector<Entry> _entries;
+    // CSR layout: entries of cell c are _cellEntries[_cellStart[c] .. _cellStart[c + 1])
+    std::vector<uint32_t> _cellStart;
+    std::vector<uint32_t> _cellEntries;
+    std::vector<uint32_t> _cursor;
+    // Boxes in _cellEntries order, for the batch kernel
+    AABBBatch _cellBoxes;
+};
@@ -0,0 +1,84 @@
+#pragma once
+// SpscQueue - bounded lock-free single-producer / single-consumer ring buffer.
+//
+// Exactly one thread may call try_push() and exactly one (other) thread may
+// call try_pop(). Head and tail are plain atomics published with
+// release/acquire ordering, so an element is fully written before the
+// consumer can see it. No locks, no allocation after construction.
+//
+// Public API:
+//  - SpscQueue(capacity)       capacity is rounded up to a power of two
+//  - try_push(value) -> bool   false when full (caller decides: drop or retry)
+//  - try_pop(out) -> bool      false when empty
+//  - capacity()
+//
+// Head and tail live on separate cache lines (and each side caches the other
+// side's index) so the producer and the consumer don't bounce a line between
+// cores on every operation.
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(std::size_t capacity)
+        : _capacity(roundUpPow2(capacity < 2 ? 2 : capacity)),
+          _mask(_capacity - 1),
+          _buffer(new T[_capacity]) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    std::size_t capacity() const noexcept { return _capacity; }
+
+    // Producer side. The value is only moved from when the push succeeds,
+    // so a caller can retry with the same object.
+    template <typename U>
+    bool try_push(U&& value) {
+        const std::size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _cachedHead == _capacity) {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if (tail - _cachedHead == _capacity) return false;
+        }
+        _buffer[tail & _mask] = std::forward<U>(value);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool try_pop(T& out) {
+        const std::size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _cachedTail) {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head == _cachedTail) return false;
+        }
+        out = std::move(_buffer[head & _mask]);
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    static constexpr std::size_t CACHE_LINE = 64;
+
+    static std::size_t roundUpPow2(std::size_t v) {
+        std::size_t p = 1;
+        while (p < v) p <<= 1;
+        return p;
+    }
+
+    const std::size_t _capacity;
+    const std::size_t _mask;
+    std::unique_ptr<T[]> _buffer;
+
+    // Consumer-owned line
+    alignas(CACHE_LINE) std::atomic<std::size_t> _head{0};
+    std::size_t _cachedTail{0};
+
+    // Producer-owned line
+    alignas(CACHE_LINE) std::atomic<std::size_t> _tail{0};
+    std::size_t _cachedHead{0};
+
+    char _pad[CACHE_LINE - sizeof(std::atomic<std::size_t>) - sizeof(std::size_t)];
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+/**
+ * @brief Fixed-bucket histogram of durations (tick work time, wake-up lateness)
+ *
+ * Buckets are powers of two in microseconds: [0, 64us), [64us, 128us), ...,
+ * with the last bucket catching everything above ~33ms. Recording is a couple
+ * of integer operations so it can run every tick on the game thread.
+ */
+class TickHistogram {
+public:
+    static constexpr std::size_t BUCKETS = 11;
+
+    void record(std::chrono::nanoseconds duration) {
+        int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        if (us < 0) us = 0;
+
+        std::size_t bucket = 0;
+        int64_t upper = FIRST_BUCKET_US;
+        while (bucket + 1 < BUCKETS && us >= upper) {
+            ++bucket;
+            upper <<= 1;
+        }
+
+        ++_counts[bucket];
+        ++_samples;
+        _totalUs += us;
+        if (us > _maxUs) _maxUs = us;
+    }
+
+    void reset() {
+        _counts.fill(0);
+        _samples = 0;
+        _totalUs = 0;
+        _maxUs = 0;
+    }
+
+    uint64_t samples() const noexcept { return _samples; }
+    int64_t maxUs() const noexcept { return _maxUs; }
+    int64_t meanUs() const noexcept { return _samples ? _totalUs / static_cast<int64_t>(_samples) : 0; }
+
+    // One line: "n=600 mean=412us max=1830us | <64us:12 <128us:40 ... >=32768us:0"
+    void print(std::ostream& os) const {
+        os << "n=" << _samples << " mean=" << meanUs() << "us max=" << _maxUs << "us |";
+        int64_t upper = FIRST_BUCKET_US;
+        for (std::size_t b = 0; b < BUCKETS; ++b) {
+            if (b + 1 < BUCKETS) {
+                os << " <" << upper << "us:" << _counts[b];
+                upper <<= 1;
+            } else {
+                os << " >=" << (upper >> 1) << "us:" << _counts[b];
+            }
+        }
+    }
+
+private:
+    static constexpr int64_t FIRST_BUCKET_US = 64;
+
+    std::array<uint64_t, BUCKETS> _counts{};
+    uint64_t _samples{0};
+    int64_t _totalUs{0};
+    int64_t _maxUs{0};
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Collision.hpp"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Static level geometry as a packed solid/empty bitmap
+ *
+ * One bit per tile, 64 tiles per word, row-major. Terrain costs no entities:
+ * queries test whole words against a column mask, so an AABB query touches
+ * one or two words per tile row it spans. sweep() only runs the exact
+ * swept test on the solid tiles of the rows that pass the word test.
+ *
+ * Queries take map coordinates (pixels from the start of the level). The
+ * level repeats horizontally, so x wraps around width(); above the first
+ * row and below the last one everything is empty. The server and clients
+ * call generate() with the same level ID and get the same map, so only the
+ * ID goes on the wire.
+ */
+class TileMap {
+public:
+    // Layout of the generated levels: 32px tiles covering the 600px screen
+    // height, 256 columns (8192px) before the level repeats
+    static constexpr int LEVEL_COLUMNS = 256;
+    static constexpr int LEVEL_ROWS = 19;
+    static constexpr float LEVEL_TILE_SIZE = 32.0f;
+
+    TileMap() = default;
+    TileMap(int columns, int rows, float tileSize);
+
+    // Deterministic level from its ID (same result on every platform).
+    // Level 0 is empty.
+    static TileMap generate(uint32_t levelId, int columns = LEVEL_COLUMNS, int rows = LEVEL_ROWS,
+                            float tileSize = LEVEL_TILE_SIZE);
+
+    void set(int column, int row, bool solid);
+    bool solid(int column, int row) const;
+
+    bool solidAt(float x, float y) const;
+    bool overlaps(const AABB& box) const;
+    // Box moving by (dx, dy): writes the normalized time of the first
+    // overlap (0 = start, 1 = end) to toi
+    bool sweep(const AABB& box, float dx, float dy, float& toi) const;
+
+    bool empty() const noexcept { return _solidCount == 0; }
+    int columns() const noexcept { return _columns; }
+    int rows() const noexcept { return _rows; }
+    float tileSize() const noexcept { return _tileSize; }
+    float width() const noexcept { return _columns * _tileSize; }
+
+private:
+    // Any solid tile in columns [c0, c1] of a row (c0 <= c1 < _columns)
+    bool anySolid(int row, int c0, int c1) const;
+    int wrapColumn(int column) const;
+
+    int _columns{0};
+    int _rows{0};
+    int _wordsPerRow{0};
+    float _tileSize{1.0f};
+    float _invTileSize{1.0f};
+    std::size_t _solidCount{0};
+    std::vector<uint64_t> _bits;
+};
@@ -0,0 +1,192 @@
+#pragma once
+// TimerWheel - hierarchical timing wheel counted in simulation ticks.
+//
+// Four levels of 64 slots each: level 0 holds timers due in the current block
+// of 64 ticks, level 1 those due in the current block of 64*64 ticks, and so
+// on (up to 2^24 ticks, ~77 hours at 60 Hz; later timers park in level 3 and
+// are re-filed when their slot comes up).
+//
+// Public API:
+//  - schedule(delayTicks, payload) -> handle        O(1)
+//  - cancel(handle) -> bool                         O(1), stale handles are ignored
+//  - find(handle) -> Payload*                       O(1), payload of a pending
+//                                                   timer (nullptr if stale)
+//  - advance(callback)                              moves one tick forward and
+//                                                   calls callback(payload) for
+//                                                   every timer due on that tick;
+//                                                   callbacks may schedule and
+//                                                   cancel timers
+//  - now() -> current tick
+//
+// Each tick only touches the level 0 slot that fires, plus one higher-level
+// slot every 64 ticks (cascade), so the cost scales with expirations rather
+// than with the number of pending timers.
+//
+// Timers live in a node pool linked into slot lists by index; handles carry a
+// generation so a handle kept after its timer fired (or was cancelled) can
+// never cancel a recycled node. Handle 0 is never returned (invalid handle).
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+template <typename Payload>
+class TimerWheel {
+public:
+    using handle_type = uint64_t;
+    static constexpr handle_type invalid_handle = 0;
+
+    explicit TimerWheel(uint64_t startTick = 0) : _now(startTick) {
+        for (auto& level : _slots) {
+            for (auto& head : level) head = NIL;
+        }
+    }
+
+    uint64_t now() const noexcept { return _now; }
+    std::size_t pending() const noexcept { return _pending; }
+
+    // Schedule payload to fire delayTicks ticks from now (0 is treated as 1)
+    handle_type schedule(uint64_t delayTicks, Payload payload) {
+        if (delayTicks == 0) delayTicks = 1;
+
+        uint32_t index;
+        if (!_freeNodes.empty()) {
+            index = _freeNodes.back();
+            _freeNodes.pop_back();
+        } else {
+            index = static_cast<uint32_t>(_nodes.size());
+            _nodes.emplace_back();
+        }
+
+        Node& n = _nodes[index];
+        n.expiry = _now + delayTicks;
+        n.payload = std::move(payload);
+        n.active = true;
+        link(index);
+        ++_pending;
+        return (static_cast<handle_type>(n.generation) << 32) | (index + 1);
+    }
+
+    bool cancel(handle_type handle) {
+        uint32_t index = pendingNode(handle);
+        if (index == NIL) return false;
+        unlink(index);
+        release(index);
+        return true;
+    }
+
+    // The payload may be changed in place (e.g. to retarget the timer)
+    Payload* find(handle_type handle) {
+        uint32_t index = pendingNode(handle);
+        return index == NIL ? nullptr : &_nodes[index].payload;
+    }
+
+    template <typename Callback>
+    void advance(Callback&& callback) {
+        ++_now;
+
+        // Cascade higher levels whose block starts on this tick (highest first)
+        if ((_now & SLOT_MASK) == 0) {
+            int top = 1;
+            while (top < LEVELS - 1 && ((_now >> (SLOT_BITS * top)) & SLOT_MASK) == 0) ++top;
+            for (int level = top; level >= 1; --level) {
+                cascade(level, static_cast<std::size_t>((_now >> (SLOT_BITS * level)) & SLOT_MASK));
+            }
+        }
+
+        // Fire everything due now, one node at a time off the slot head, so a
+        // callback may cancel a timer due on this tick (unlinked, never
+        // fires) or schedule new ones (always in a later slot)
+        const std::size_t slot = static_cast<std::size_t>(_now & SLOT_MASK);
+        while (_slots[0][slot] != NIL) {
+            uint32_t index = _slots[0][slot];
+            unlink(index);
+            Payload payload = std::move(_nodes[index].payload);
+            release(index);
+            callback(payload);
+        }
+    }
+
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr uint64_t SLOT_MASK = (1u << SLOT_BITS) - 1;
+    static constexpr std::size_t SLOTS = std::size_t(1) << SLOT_BITS;
+    static constexpr uint32_t NIL = 0xFFFFFFFFu;
+
+    struct Node {
+        uint64_t expiry{0};
+        uint32_t next{NIL};
+        uint32_t prev{NIL};
+        uint32_t generation{1};
+        uint8_t level{0};
+        uint8_t slot{0};
+        bool active{false};
+        Payload payload{};
+    };
+
+    uint32_t pendingNode(handle_type handle) const {
+        if (handle == invalid_handle) return NIL;
+        uint32_t index = static_cast<uint32_t>(handle & 0xFFFFFFFFu) - 1;
+        uint32_t generation = static_cast<uint32_t>(handle >> 32);
+        if (index >= _nodes.size()) return NIL;
+        const Node& n = _nodes[index];
+        return n.active && n.generation == generation ? index : NIL;
+    }
+
+    // File a node by the highest block it shares with the current tick
+    void link(uint32_t index) {
+        Node& n = _nodes[index];
+        int level = 0;
+        while (level < LEVELS - 1 && (n.expiry >> (SLOT_BITS * (level + 1))) != (_now >> (SLOT_BITS * (level + 1)))) {
+            ++level;
+        }
+        // A cascade may file a timer due on the current tick: it lands in the
+        // level 0 slot that advance() is about to fire
+        n.level = static_cast<uint8_t>(level);
+        n.slot = static_cast<uint8_t>((n.expiry >> (SLOT_BITS * level)) & SLOT_MASK);
+
+        uint32_t& head = _slots[level][n.slot];
+        n.prev = NIL;
+        n.next = head;
+        if (head != NIL) _nodes[head].prev = index;
+        head = index;
+    }
+
+    void unlink(uint32_t index) {
+        Node& n = _nodes[index];
+        if (n.prev != NIL) {
+            _nodes[n.prev].next = n.next;
+        } else {
+            _slots[n.level][n.slot] = n.next;
+        }
+        if (n.next != NIL) _nodes[n.next].prev = n.prev;
+        n.next = NIL;
+        n.prev = NIL;
+    }
+
+    void release(uint32_t index) {
+        Node& n = _nodes[index];
+        n.active = false;
+        ++n.generation;
+        if (n.generation == 0) n.generation = 1;
+        _freeNodes.push_back(index);
+        --_pending;
+    }
+
+    void cascade(int level, std::size_t slot) {
+        uint32_t index = _slots[level][slot];
+        _slots[level][slot] = NIL;
+        while (index != NIL) {
+            uint32_t next = _nodes[index].next;
+            link(index);
+            index = next;
+        }
+    }
+
+    uint64_t _now;
+    std::size_t _pending{0};
+    std::vector<Node> _nodes;
+    std::vector<uint32_t> _freeNodes;
+    uint32_t _slots[LEVELS][SLOTS];
+};
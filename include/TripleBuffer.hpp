@@ -0,0 +1,53 @@
+#pragma once
+// TripleBuffer - lock-free "latest value" channel between one writer and one reader.
+//
+// The writer fills writeBuffer() then publish()es it; the reader calls fetch()
+// and, when it returns true, reads readBuffer(). Neither side ever waits for
+// the other: the writer always has a free buffer to fill, and the reader keeps
+// the buffer it is using until it fetches a newer one. Values published while
+// the reader is busy are overwritten (the reader only cares about the latest).
+//
+// A writer that cannot lose a value can check unfetched() before publishing
+// and fold what the reader hasn't taken yet into the new value. The reader
+// may still fetch the old value in between, so it may see the same data
+// twice but never misses it.
+//
+// Buffers are reused in rotation, so a T holding vectors keeps its capacity and
+// the steady state does not allocate. The writer must overwrite the whole value
+// (it gets back an older buffer, not the one it just published).
+#include <atomic>
+#include <cstdint>
+
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer side
+    T& writeBuffer() noexcept { return _buffers[_write]; }
+
+    void publish() noexcept {
+        uint8_t previous = _middle.exchange(static_cast<uint8_t>(_write | NEW_BIT), std::memory_order_acq_rel);
+        _write = previous & INDEX_MASK;
+    }
+
+    // True while the last published value hasn't been fetched
+    bool unfetched() const noexcept { return _middle.load(std::memory_order_acquire) & NEW_BIT; }
+
+    // Reader side
+    bool fetch() noexcept {
+        if (!(_middle.load(std::memory_order_relaxed) & NEW_BIT)) return false;
+        uint8_t previous = _middle.exchange(_read, std::memory_order_acq_rel);
+        _read = previous & INDEX_MASK;
+        return true;
+    }
+
+    const T& readBuffer() const noexcept { return _buffers[_read]; }
+
+private:
+    static constexpr uint8_t NEW_BIT = 0x4;
+    static constexpr uint8_t INDEX_MASK = 0x3;
+
+    T _buffers[3];
+    uint8_t _write{0};
+    std::atomic<uint8_t> _middle{1};
+    uint8_t _read{2};
+};
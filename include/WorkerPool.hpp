@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of threads running parallel-for batches
+ *
+ * run(count, job) calls job(i) once for every i in [0, count), spread over
+ * the pool threads and the calling thread, and returns when all calls are
+ * done. Jobs are handed out one index at a time from a shared counter, so a
+ * slow job does not hold back the others.
+ *
+ * The thread count never depends on the amount of work: between batches the
+ * threads sleep on a condition variable. Only one thread may call run() at a
+ * time; a job may call run() again on the same pool (a room ticked on the
+ * pool splitting its own work), that inner batch then runs inline on the
+ * job's thread. Everything a job writes is visible to the caller once run()
+ * returns.
+ */
+class WorkerPool {
+public:
+    using Job = std::function<void(std::size_t)>;
+
+    // threads: total number of threads including the caller of run();
+    // 0 picks one per hardware thread
+    explicit WorkerPool(std::size_t threads = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void run(std::size_t count, const Job& job);
+
+    std::size_t size() const noexcept { return _threads.size() + 1; }
+
+    // True on a thread running one of this pool's jobs, where run() would
+    // not spread the work any further
+    bool inJob() const noexcept;
+
+private:
+    void workerLoop();
+    void work(const Job& job);
+
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+
+    // Current batch, guarded by _mutex (except the index counter)
+    const Job* _job{nullptr};
+    std::size_t _count{0};
+    std::atomic<std::size_t> _next{0};
+    std::size_t _busy{0};
+    uint64_t _generation{0};
+    bool _stopping{false};
+};
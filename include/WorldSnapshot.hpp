@@ -0,0 +1,39 @@
+#pragma once
+
+#include <asio.hpp>
+#include "Protocol.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Immutable per-tick view of the world, published by the simulation
+ *
+ * A room fills one of these at the end of every tick where a client is due a
+ * snapshot and hands it to the network sender thread through a TripleBuffer;
+ * the sender encodes and sends it without touching the ECS. Each recipient
+ * comes with the newest snapshot it acknowledged, which the sender encodes
+ * the new one against (see SnapshotDelta.hpp).
+ */
+struct WorldSnapshot {
+    struct Recipient {
+        asio::ip::udp::endpoint endpoint;
+        uint32_t ackTick{0};    // 0: nothing acknowledged, send it all
+    };
+
+    uint64_t tick{0};
+    std::vector<EntityBatchEntry> entities;
+    // Clients with a ready UDP endpoint whose send slot is this tick, or
+    // whose snapshot this one overwrote before the sender took it
+    std::vector<Recipient> recipients;
+};
+
+/**
+ * @brief Datagram produced by the simulation (spawn, destroy, world sync)
+ *
+ * Queued to the sender thread in tick order, and always sent before the
+ * snapshot of the tick that produced it.
+ */
+struct OutgoingPacket {
+    std::vector<char> data;
+    std::vector<asio::ip::udp::endpoint> targets;
+};
@@ -0,0 +1,111 @@
+#include "../include/ColliderShape.hpp"
+#include <algorithm>
+
+namespace {
+
+AABB merge(const AABB& a, const AABB& b) {
+    return AABB{std::min(a.minX, b.minX), std::min(a.minY, b.minY),
+                std::max(a.maxX, b.maxX), std::max(a.maxY, b.maxY)};
+}
+
+// Depth is logarithmic in the number of hitboxes, 64 is far more than enough
+constexpr std::size_t MAX_STACK = 64;
+
+} // namespace
+
+ColliderShape::ColliderShape(std::vector<AABB> localBoxes)
+    : _boxes(std::move(localBoxes)) {
+    if (_boxes.empty()) {
+        return;
+    }
+
+    _nodes.reserve(2 * (_boxes.size() / LEAF_SIZE + 1));
+    _nodes.push_back(Node{});
+    buildNode(0, 0, static_cast<uint32_t>(_boxes.size()));
+    _bounds = _nodes[0].box;
+}
+
+void ColliderShape::buildNode(uint32_t node, uint32_t first, uint32_t count) {
+    AABB box = _boxes[first];
+    for (uint32_t i = first + 1; i < first + count; ++i) {
+        box = merge(box, _boxes[i]);
+    }
+
+    if (count <= LEAF_SIZE) {
+        _nodes[node] = Node{box, first, count};
+        return;
+    }
+
+    // Median split of the hitbox centers along the longest axis
+    bool splitX = (box.maxX - box.minX) >= (box.maxY - box.minY);
+    uint32_t half = count / 2;
+    auto begin = _boxes.begin() + first;
+    std::nth_element(begin, begin + half, begin + count, [splitX](const AABB& a, const AABB& b) {
+        return splitX ? (a.minX + a.maxX) < (b.minX + b.maxX)
+                      : (a.minY + a.maxY) < (b.minY + b.maxY);
+    });
+
+    uint32_t left = static_cast<uint32_t>(_nodes.size());
+    _nodes.push_back(Node{});
+    _nodes.push_back(Node{});
+    _nodes[node] = Node{box, left, 0};
+
+    buildNode(left, first, half);
+    buildNode(left + 1, first + half, count - half);
+}
+
+bool ColliderShape::overlaps(const AABB& localProbe) const {
+    if (_nodes.empty()) return false;
+
+    uint32_t stack[MAX_STACK];
+    std::size_t top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const Node& n = _nodes[stack[--top]];
+        if (!aabbOverlap(localProbe, n.box)) continue;
+
+        if (n.count > 0) {
+            for (uint32_t i = n.first; i < n.first + n.count; ++i) {
+                if (aabbOverlap(localProbe, _boxes[i])) return true;
+            }
+        } else {
+            stack[top++] = n.first;
+            stack[top++] = n.first + 1;
+        }
+    }
+    return false;
+}
+
+bool ColliderShape::sweep(const AABB& localStart, float dx, float dy, float& toi) const {
+    if (_nodes.empty()) return false;
+
+    const AABB swept = sweptBounds(localStart, dx, dy);
+    bool hit = false;
+    float best = 1.0f;
+
+    uint32_t stack[MAX_STACK];
+    std::size_t top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const Node& n = _nodes[stack[--top]];
+        if (!aabbOverlap(swept, n.box)) continue;
+
+        if (n.count > 0) {
+            for (uint32_t i = n.first; i < n.first + n.count; ++i) {
+                float t;
+                if (sweptAABB(localStart, dx, dy, _boxes[i], t) && (!hit || t < best)) {
+                    best = t;
+                    hit = true;
+                }
+            }
+        } else {
+            stack[top++] = n.first;
+            stack[top++] = n.first + 1;
+        }
+    }
+
+    if (hit) toi = best;
+    return hit;
+}
@@ -0,0 +1,93 @@
+#include "../include/Collision.hpp"
+#include <cstring>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define RTYPE_COLLISION_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RTYPE_COLLISION_SSE 1
+#endif
+
+namespace {
+
+inline uint32_t popcount32(uint32_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint32_t>(__builtin_popcount(v));
+#else
+    uint32_t n = 0;
+    for (; v; v &= v - 1) ++n;
+    return n;
+#endif
+}
+
+} // namespace
+
+std::size_t overlapBatch(const AABB& probe,
+                         const float* minX, const float* minY,
+                         const float* maxX, const float* maxY,
+                         std::size_t count, uint32_t* hitMask) {
+    std::memset(hitMask, 0, ((count + 31) / 32) * sizeof(uint32_t));
+
+    std::size_t hits = 0;
+    std::size_t i = 0;
+
+#if defined(RTYPE_COLLISION_AVX)
+    const __m256 pMinX = _mm256_set1_ps(probe.minX);
+    const __m256 pMinY = _mm256_set1_ps(probe.minY);
+    const __m256 pMaxX = _mm256_set1_ps(probe.maxX);
+    const __m256 pMaxY = _mm256_set1_ps(probe.maxY);
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 m = _mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(pMinX, _mm256_loadu_ps(maxX + i), _CMP_LT_OQ),
+                          _mm256_cmp_ps(pMaxX, _mm256_loadu_ps(minX + i), _CMP_GT_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(pMinY, _mm256_loadu_ps(maxY + i), _CMP_LT_OQ),
+                          _mm256_cmp_ps(pMaxY, _mm256_loadu_ps(minY + i), _CMP_GT_OQ)));
+        uint32_t bits = static_cast<uint32_t>(_mm256_movemask_ps(m));
+        if (bits) {
+            hitMask[i / 32] |= bits << (i % 32);
+            hits += popcount32(bits);
+        }
+    }
+#elif defined(RTYPE_COLLISION_SSE)
+    const __m128 pMinX = _mm_set1_ps(probe.minX);
+    const __m128 pMinY = _mm_set1_ps(probe.minY);
+    const __m128 pMaxX = _mm_set1_ps(probe.maxX);
+    const __m128 pMaxY = _mm_set1_ps(probe.maxY);
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 m = _mm_and_ps(
+            _mm_and_ps(_mm_cmplt_ps(pMinX, _mm_loadu_ps(maxX + i)),
+                       _mm_cmpgt_ps(pMaxX, _mm_loadu_ps(minX + i))),
+            _mm_and_ps(_mm_cmplt_ps(pMinY, _mm_loadu_ps(maxY + i)),
+                       _mm_cmpgt_ps(pMaxY, _mm_loadu_ps(minY + i))));
+        uint32_t bits = static_cast<uint32_t>(_mm_movemask_ps(m));
+        if (bits) {
+            hitMask[i / 32] |= bits << (i % 32);
+            hits += popcount32(bits);
+        }
+    }
+#endif
+
+    // Scalar tail (and whole loop when no SIMD is available)
+    for (; i < count; ++i) {
+        if (probe.minX < maxX[i] && probe.maxX > minX[i] &&
+            probe.minY < maxY[i] && probe.maxY > minY[i]) {
+            hitMask[i / 32] |= 1u << (i % 32);
+            ++hits;
+        }
+    }
+
+    return hits;
+}
+
+const char* collisionKernelName() {
+#if defined(RTYPE_COLLISION_AVX)
+    return "avx (8 boxes/op)";
+#elif defined(RTYPE_COLLISION_SSE)
+    return "sse (4 boxes/op)";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,75 @@
+#include "../include/FlowField.hpp"
+#include <algorithm>
+#include <cmath>
+
+FlowField::FlowField(float originX, float originY, float width, float height, float cellSize)
+    : _originX(originX),
+      _originY(originY),
+      _cellSize(cellSize),
+      _invCellSize(1.0f / cellSize),
+      _columns(std::max(1, static_cast<int>(std::ceil(width / cellSize)))),
+      _rows(std::max(1, static_cast<int>(std::ceil(height / cellSize)))),
+      _empty(true) {
+    _dirX.assign(static_cast<std::size_t>(_columns) * _rows, 0.0f);
+    _dirY.assign(static_cast<std::size_t>(_columns) * _rows, 0.0f);
+}
+
+void FlowField::build(const std::vector<Target>& targets) {
+    _empty = targets.empty();
+    if (_empty) {
+        return;
+    }
+
+    for (int cy = 0; cy < _rows; ++cy) {
+        const float centerY = _originY + (cy + 0.5f) * _cellSize;
+        for (int cx = 0; cx < _columns; ++cx) {
+            const float centerX = _originX + (cx + 0.5f) * _cellSize;
+
+            // Nearest target from the cell center
+            float bestX = 0.0f;
+            float bestY = 0.0f;
+            float best = -1.0f;
+            for (const Target& t : targets) {
+                const float dx = t.x - centerX;
+                const float dy = t.y - centerY;
+                const float d2 = dx * dx + dy * dy;
+                if (best < 0.0f || d2 < best) {
+                    best = d2;
+                    bestX = dx;
+                    bestY = dy;
+                }
+            }
+
+            const std::size_t cell = static_cast<std::size_t>(cy) * _columns + cx;
+            const float length = std::sqrt(best);
+            // Target inside the cell: no meaningful direction from the center
+            if (length < _cellSize * 0.5f) {
+                _dirX[cell] = 0.0f;
+                _dirY[cell] = 0.0f;
+            } else {
+                _dirX[cell] = bestX / length;
+                _dirY[cell] = bestY / length;
+            }
+        }
+    }
+}
+
+bool FlowField::sample(float x, float y, float& dirX, float& dirY) const {
+    if (_empty) {
+        return false;
+    }
+    const std::size_t cell = static_cast<std::size_t>(cellY(y)) * _columns + cellX(x);
+    dirX = _dirX[cell];
+    dirY = _dirY[cell];
+    return dirX != 0.0f || dirY != 0.0f;
+}
+
+int FlowField::cellX(float x) const {
+    int c = static_cast<int>(std::floor((x - _originX) * _invCellSize));
+    return std::clamp(c, 0, _columns - 1);
+}
+
+int FlowField::cellY(float y) const {
+    int c = static_cast<int>(std::floor((y - _originY) * _invCellSize));
+    return std::clamp(c, 0, _rows - 1);
+}
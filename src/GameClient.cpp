@@ -1,8 +1,10 @@
 #include "../include/GameClient.hpp"
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <cstring>
+#include <cmath>
 
 GameClient::GameClient(const std::string& host, short tcpPort)
     : _tcpSocket(_ioContext),
@@ -12,7 +14,16 @@ GameClient::GameClient(const std::string& host, short tcpPort)
       _udpPort(0),
       _playerId(0),
       _sessionToken(0),
-      _connected(false) {
+      _inputSequence(0),
+      _snapshotTick(0),
+      _connected(false),
+      _levelId(0),
+      _scrollAnchor(0.0f),
+      _scrollSpeed(0.0f),
+      _assemblyTick(0),
+      _assemblyBaseline(0),
+      _assemblyExpected(0),
+      _assemblyReceived(0) {
 }
 
 GameClient::~GameClient() {
@@ -24,7 +35,7 @@ GameClient::~GameClient() {
     }
 }
 
-bool GameClient::connect(const std::string& username) {
+bool GameClient::connect(const std::string& username, int snapshotRate) {
     try {
         // Connect TCP
         std::cout << "[Client] Connecting to " << _host << ":" << _tcpPort << "..." << std::endl;
@@ -38,6 +49,9 @@ bool GameClient::connect(const std::string& username) {
         connectMsg.type = TCPProtocol::CONNECT;
         connectMsg.params["username"] = username;
         connectMsg.params["version"] = "1.0";
+        if (snapshotRate > 0) {
+            connectMsg.params["snapshot_rate"] = std::to_string(snapshotRate);
+        }
         
         std::string request = connectMsg.serialize();
         asio::write(_tcpSocket, asio::buffer(request));
@@ -59,11 +73,17 @@ bool GameClient::connect(const std::string& username) {
         ss << std::hex << responseMsg.params["token"];
         ss >> _sessionToken;
         _udpPort = std::stoi(responseMsg.params["udp_port"]);
+        if (responseMsg.params.count("level")) {
+            loadLevel(static_cast<uint32_t>(std::stoul(responseMsg.params["level"])));
+        }
 
         std::cout << "[Client] Authenticated!" << std::endl;
         std::cout << "         Player ID: " << (int)_playerId << std::endl;
         std::cout << "         Token: 0x" << std::hex << _sessionToken << std::dec << std::endl;
         std::cout << "         UDP Port: " << _udpPort << std::endl;
+        if (responseMsg.params.count("snapshot_rate")) {
+            std::cout << "         Snapshots: " << responseMsg.params["snapshot_rate"] << " Hz" << std::endl;
+        }
 
         // Setup UDP
         _udpSocket.open(asio::ip::udp::v4());
@@ -114,6 +134,8 @@ void GameClient::sendInput(int8_t moveX, int8_t moveY, uint8_t buttons) {
     payload.buttons = buttons;
     payload.moveX = moveX;
     payload.moveY = moveY;
+    payload.sequence = _inputSequence++;
+    payload.snapshotTick = _snapshotTick;
 
     // Send packet
     std::vector<char> packet(sizeof(PacketHeader) + sizeof(PlayerInputPayload));
@@ -182,12 +204,20 @@ void GameClient::update() {
                 break;
             case ENTITY_BATCH_UPDATE:
                 if (VERBOSE_LOGGING) std::cout << "[Client] Processing ENTITY_BATCH_UPDATE packet" << std::endl;
-                handleEntityBatchUpdate(_udpBuffer);
+                handleEntityBatchUpdate(_udpBuffer, length);
                 break;
             case ENTITY_DESTROY:
                 if (VERBOSE_LOGGING) std::cout << "[Client] Processing ENTITY_DESTROY packet" << std::endl;
                 handleEntityDestroy(_udpBuffer);
                 break;
+            case ENTITY_CURVE:
+                if (VERBOSE_LOGGING) std::cout << "[Client] Processing ENTITY_CURVE packet" << std::endl;
+                handleEntityCurve(_udpBuffer);
+                break;
+            case LEVEL_SCROLL:
+                if (VERBOSE_LOGGING) std::cout << "[Client] Processing LEVEL_SCROLL packet" << std::endl;
+                handleLevelScroll(_udpBuffer);
+                break;
             default:
                 std::cerr << "[Client] Unknown packet type: " << (int)header.type << std::endl;
                 break;
@@ -198,6 +228,8 @@ void GameClient::update() {
         std::cout << "[Client] Processed " << packetsProcessed << " packets, "
                   << "total entities: " << _entities.size() << std::endl;
     }
+
+    advanceCurves();
 }
 
 void GameClient::handleEntitySpawn(const char* data) {
@@ -242,9 +274,9 @@ void GameClient::handleEntitySpawn(const char* data) {
         entity.g = 255;
         entity.b = 0;
     } else if (payload.entityType == BULLET_ENEMY) {
-        // Enemy bullets - red and thin
+        // Enemy bullets - small red squares (same box as the server hitbox)
         entity.width = 8.0f;
-        entity.height = 2.0f;
+        entity.height = 8.0f;
         entity.r = 255;
         entity.g = 0;
         entity.b = 0;
@@ -278,22 +310,93 @@ void GameClient::handleEntityUpdate(const char* data) {
     }
 }
 
-void GameClient::handleEntityBatchUpdate(const char* data) {
+void GameClient::handleEntityBatchUpdate(const char* data, size_t length) {
     static const bool VERBOSE_LOGGING = false;
 
-    uint8_t count;
-    std::memcpy(&count, data + sizeof(PacketHeader), sizeof(uint8_t));
+    if (length < sizeof(PacketHeader) + sizeof(EntityBatchHeader)) {
+        return;
+    }
+    EntityBatchHeader batch;
+    std::memcpy(&batch, data + sizeof(PacketHeader), sizeof(EntityBatchHeader));
+    if (batch.fragment >= batch.fragmentCount) {
+        std::cerr << "[Client] Malformed snapshot fragment" << std::endl;
+        return;
+    }
 
     if (VERBOSE_LOGGING) {
-        std::cout << "[Client] Batch update with " << (int)count << " entities" << std::endl;
+        std::cout << "[Client] Snapshot " << batch.tick << " (baseline " << batch.baselineTick << ") fragment "
+                  << batch.fragment + 1 << "/" << batch.fragmentCount << " with " << batch.count
+                  << " entities" << std::endl;
     }
 
-    const char* entryData = data + sizeof(PacketHeader) + sizeof(uint8_t);
-    
-    for (uint8_t i = 0; i < count; ++i) {
-        EntityBatchEntry entry;
-        std::memcpy(&entry, entryData + i * sizeof(EntityBatchEntry), sizeof(EntityBatchEntry));
+    // Fragments of a snapshot older than the one rebuilt or being assembled
+    // arrived late: newer positions are already known
+    if (static_cast<int32_t>(batch.tick - _snapshotTick) <= 0 ||
+        (_assemblyExpected > 0 && static_cast<int32_t>(batch.tick - _assemblyTick) < 0)) {
+        return;
+    }
+    if (_assemblyExpected == 0 || batch.tick != _assemblyTick) {
+        if (_assemblyExpected > 0) {
+            applySnapshot(false);
+        }
+        _assemblyTick = batch.tick;
+        _assemblyBaseline = batch.baselineTick;
+        _assemblyExpected = batch.fragmentCount;
+        _assemblyFragments.assign(batch.fragmentCount, false);
+        _assemblyReceived = 0;
+        _assemblyDeltas.clear();
+    }
+    if (batch.fragmentCount != _assemblyExpected || _assemblyFragments[batch.fragment]) {
+        return;  // Duplicate
+    }
+
+    const char* entryData = data + sizeof(PacketHeader) + sizeof(EntityBatchHeader);
+    std::size_t entrySize = length - sizeof(PacketHeader) - sizeof(EntityBatchHeader);
+    std::size_t before = _assemblyDeltas.size();
+    if (!readSnapshotDelta(entryData, entrySize, batch.count, _assemblyDeltas)) {
+        std::cerr << "[Client] Malformed snapshot fragment" << std::endl;
+        _assemblyDeltas.resize(before);
+        return;
+    }
+    _assemblyFragments[batch.fragment] = true;
+    ++_assemblyReceived;
+
+    if (_assemblyReceived == _assemblyExpected) {
+        applySnapshot(true);
+    }
+}
 
+void GameClient::applySnapshot(bool complete) {
+    static const std::vector<EntityBatchEntry> noBaseline;
+    _assemblyExpected = 0;
+
+    const std::vector<EntityBatchEntry>* baseline = &noBaseline;
+    if (_assemblyBaseline != 0) {
+        baseline = _snapshots.find(_assemblyBaseline);
+        if (!baseline) {
+            // Older than the history: the next snapshot uses a newer ack
+            std::cerr << "[Client] Snapshot " << _assemblyTick << " is a delta against " << _assemblyBaseline
+                      << ", which is no longer kept" << std::endl;
+            return;
+        }
+    }
+
+    // Fragments may arrive in any order
+    std::sort(_assemblyDeltas.begin(), _assemblyDeltas.end(), [](const DeltaEntry& a, const DeltaEntry& b) {
+        return a.state.networkId < b.state.networkId;
+    });
+    applySnapshotDelta(*baseline, _assemblyDeltas, _rebuilt);
+
+    // An incomplete snapshot only tells about the entities it received
+    auto received = [this](uint32_t networkId) {
+        auto it = std::lower_bound(_assemblyDeltas.begin(), _assemblyDeltas.end(), networkId,
+                                   [](const DeltaEntry& d, uint32_t id) { return d.state.networkId < id; });
+        return it != _assemblyDeltas.end() && it->state.networkId == networkId;
+    };
+    for (const EntityBatchEntry& entry : _rebuilt) {
+        if (!complete && !received(entry.networkId)) {
+            continue;
+        }
         auto it = _entities.find(entry.networkId);
         if (it != _entities.end()) {
             it->second.x = entry.posX;
@@ -303,6 +406,13 @@ void GameClient::handleEntityBatchUpdate(const char* data) {
             std::cerr << "[Client] Received update for unknown entity: " << entry.networkId << std::endl;
         }
     }
+
+    // Only a complete snapshot can be a baseline: it is acknowledged by
+    // echoing its tick, and the server rewinds our shots to it
+    if (complete) {
+        _snapshots.store(_assemblyTick) = _rebuilt;
+        _snapshotTick = _assemblyTick;
+    }
 }
 
 void GameClient::handleEntityDestroy(const char* data) {
@@ -315,3 +425,61 @@ void GameClient::handleEntityDestroy(const char* data) {
         _entities.erase(it);
     }
 }
+
+void GameClient::handleEntityCurve(const char* data) {
+    EntityCurvePayload payload;
+    std::memcpy(&payload, data + sizeof(PacketHeader), sizeof(EntityCurvePayload));
+
+    auto it = _entities.find(payload.networkId);
+    if (it == _entities.end() || payload.curveType >= MotionCurve::TYPE_COUNT) {
+        return;  // Spawn not received yet: the curve is resent every second
+    }
+
+    // Anchor the curve on the local clock: elapsed seconds were already
+    // spent on it when the server sent the packet
+    ClientEntity& entity = it->second;
+    entity.onCurve = true;
+    entity.curve = MotionCurve{static_cast<MotionCurve::Type>(payload.curveType), payload.originX, payload.originY};
+    std::memcpy(entity.curve.p, payload.params, sizeof(entity.curve.p));
+    entity.curveStart = std::chrono::steady_clock::now() -
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<float>(payload.elapsed));
+}
+
+void GameClient::handleLevelScroll(const char* data) {
+    LevelScrollPayload payload;
+    std::memcpy(&payload, data + sizeof(PacketHeader), sizeof(LevelScrollPayload));
+
+    if (payload.levelId != _levelId) {
+        loadLevel(payload.levelId);
+    }
+    // Same anchoring as the curves: resent every second by the server
+    _scrollAnchor = payload.scrollX;
+    _scrollSpeed = payload.scrollSpeed;
+    _scrollStart = std::chrono::steady_clock::now();
+}
+
+void GameClient::loadLevel(uint32_t levelId) {
+    _levelId = levelId;
+    _terrain = TileMap::generate(levelId);
+    std::cout << "[Client] Level " << levelId << " loaded" << std::endl;
+}
+
+float GameClient::getScroll() const {
+    if (_terrain.empty()) {
+        return 0.0f;
+    }
+    float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - _scrollStart).count();
+    return std::fmod(_scrollAnchor + _scrollSpeed * elapsed, _terrain.width());
+}
+
+void GameClient::advanceCurves() {
+    auto now = std::chrono::steady_clock::now();
+    for (auto& pair : _entities) {
+        ClientEntity& entity = pair.second;
+        if (!entity.onCurve) continue;
+
+        float t = std::chrono::duration<float>(now - entity.curveStart).count();
+        evaluateCurve(entity.curve, t, entity.x, entity.y);
+    }
+}
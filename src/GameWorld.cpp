@@ -0,0 +1,1632 @@
+#include "../include/GameWorld.hpp"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <optional>
+#include <utility>
+
+namespace {
+constexpr float PI = 3.14159265358979323846f;
+}
+
+GameWorld::GameWorld(int tickRate, bool spawnEnemies, uint32_t levelId, uint64_t seed)
+    : _tickRate(tickRate > 0 ? tickRate : 60),
+      _tickInterval(1.0f / _tickRate),
+      _nextNetworkId(1),
+      _playerBullets(_registry, &GameWorld::buildPlayerBullet, PLAYER_BULLET_POOL_SIZE),
+      _enemyBullets(_registry, &GameWorld::buildEnemyBullet, ENEMY_BULLET_POOL_SIZE),
+      _enemyGrid(0.0f, 0.0f, WORLD_WIDTH, WORLD_HEIGHT, COLLISION_CELL_SIZE),
+      _maxRewindTicks(static_cast<uint32_t>(std::ceil(LAG_COMPENSATION_WINDOW * _tickRate))),
+      _levelId(levelId),
+      _terrain(TileMap::generate(levelId)),
+      _scrollX(0.0f),
+      _flowField(0.0f, 0.0f, WORLD_WIDTH, WORLD_HEIGHT, FLOW_FIELD_CELL_SIZE),
+      _bulletStrips(1),
+      _workers(nullptr),
+      _spatialSortTicks(0),
+      _spawnRng(static_cast<std::mt19937::result_type>(deriveSeed(seed, RNG_SPAWN))),
+      _enemyRng(static_cast<std::mt19937::result_type>(deriveSeed(seed, RNG_ENEMY))),
+      _pathRng(static_cast<std::mt19937::result_type>(deriveSeed(seed, RNG_PATH))) {
+
+    // Register component storages
+    _registry.register_component<Position>();
+    _registry.register_component<Velocity>();
+    _registry.register_component<Drawable>();
+    _registry.register_component<NetworkId>();
+    _registry.register_component<PlayerOwner>();
+    _registry.register_component<Health>();
+    _registry.register_component<Damage>();
+    _registry.register_component<EntityTypeTag>();
+    _registry.register_component<Lifetime>();
+    _registry.register_component<CompoundCollider>();
+    _registry.register_component<Emitter>();
+    _registry.register_component<MotionCurve>();
+    _registry.register_component<Homing>();
+    _registry.register_component<LagCompensation>();
+
+    // Current tick plus the ticks a shot can be rewound by
+    _enemyHistory.resize(_maxRewindTicks + 1);
+
+    if (spawnEnemies) {
+        _timers.schedule(secondsToTicks(FIRST_ENEMY_SPAWN_DELAY), GameTimer{GameTimer::ENEMY_SPAWN, 0});
+    }
+    _timers.schedule(secondsToTicks(CURVE_SYNC_PERIOD), GameTimer{GameTimer::CURVE_SYNC, 0});
+    _timers.schedule(secondsToTicks(FLOW_FIELD_PERIOD), GameTimer{GameTimer::FLOW_FIELD, 0});
+}
+
+const char* TickProfile::name(Phase phase) {
+    switch (phase) {
+        case TIMERS: return "timers";
+        case SCROLL: return "scroll";
+        case HOMING: return "homing";
+        case MOTION: return "motion";
+        case CURVES: return "curves";
+        case SPATIAL_SORT: return "spatial sort";
+        case COLLISIONS: return "collisions";
+        case ENEMY_BULLETS: return "enemy bullets";
+        default: return "?";
+    }
+}
+
+namespace {
+
+template <typename Fn>
+void timed(TickProfile* profile, TickProfile::Phase phase, Fn&& fn) {
+    if (!profile) {
+        fn();
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    profile->us[phase] += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Moves the T of entity from[k] to entity to[k], for every k (to is a
+// permutation of from, so every storage keeps the same number of values)
+template <typename T>
+void permuteComponent(registry& reg, const std::vector<Entity>& from, const std::vector<Entity>& to) {
+    auto* storage = reg.get_components_if<T>();
+    if (!storage) return;
+    std::vector<std::optional<T>> moved(from.size());
+    for (std::size_t k = 0; k < from.size(); ++k) {
+        std::size_t i = static_cast<std::size_t>(from[k]);
+        if (storage->has(i)) moved[k] = std::move(storage->get_ref(i));
+    }
+    for (std::size_t k = 0; k < to.size(); ++k) {
+        storage->get_ref(static_cast<std::size_t>(to[k])) = std::move(moved[k]);
+    }
+}
+
+template <typename... Components>
+void permuteComponents(registry& reg, const std::vector<Entity>& from, const std::vector<Entity>& to) {
+    (permuteComponent<Components>(reg, from, to), ...);
+}
+
+}  // namespace
+
+void GameWorld::tick() {
+    // Storage reorder first, while nothing of this tick holds entity IDs
+    if (_spatialSortTicks != 0 && _timers.now() % _spatialSortTicks == 0) {
+        timed(_profile, TickProfile::SPATIAL_SORT, [&] { sortBySpace(); });
+    }
+    // Fire due timers (enemy spawns, volleys, bullet lifetimes, shot cooldowns)
+    timed(_profile, TickProfile::TIMERS, [&] { updateTimers(); });
+    timed(_profile, TickProfile::SCROLL, [&] { advanceScroll(); });
+    timed(_profile, TickProfile::HOMING, [&] { updateHoming(); });
+    timed(_profile, TickProfile::MOTION, [&] { updateMotion(); });
+    // Entities on a curve: position = f(t), evaluated per curve type
+    timed(_profile, TickProfile::CURVES, [&] { _curves.apply(_registry, _timers.now(), _tickInterval); });
+
+    // The enemy bullet pass is timed on its own from inside
+    double enemyBullets = _profile ? _profile->us[TickProfile::ENEMY_BULLETS] : 0.0;
+    timed(_profile, TickProfile::COLLISIONS, [&] { checkCollisions(); });
+    if (_profile) {
+        _profile->us[TickProfile::COLLISIONS] -= _profile->us[TickProfile::ENEMY_BULLETS] - enemyBullets;
+    }
+}
+
+void GameWorld::tick(TickProfile& profile) {
+    _profile = &profile;
+    tick();
+    _profile = nullptr;
+}
+
+void GameWorld::updateMotion() {
+    const float deltaTime = _tickInterval;
+
+    // Get component storages
+    auto* positions = _registry.get_components_if<Position>();
+    auto* velocities = _registry.get_components_if<Velocity>();
+    auto* drawables = _registry.get_components_if<Drawable>();
+
+    if (!positions || !velocities) {
+        return;
+    }
+
+    // Update positions based on velocities (position system), group by
+    // group: pooled projectiles waiting in their pool are in none. Enemy
+    // bullets move with their strip (updateBulletStrip).
+    auto integrate = [&](Entity entity) -> Position* {
+        std::size_t i = static_cast<std::size_t>(entity);
+        auto& pos_opt = positions->get_ref(i);
+        auto& vel_opt = velocities->get_ref(i);
+        if (!pos_opt || !vel_opt) return nullptr;
+
+        auto& pos = pos_opt.value();
+        pos.x += vel_opt.value().vx * deltaTime;
+        pos.y += vel_opt.value().vy * deltaTime;
+        return &pos;
+    };
+
+    // Enemies and bullets must be free to leave the screen so that the
+    // off-screen cleanup and the swept collision tests see their real motion
+    for (auto enemy : _enemyEntities) {
+        if (_curves.contains(enemy)) continue;  // moved by the curve system
+        integrate(enemy);
+    }
+    for (auto bullet : _bulletEntities) {
+        integrate(bullet);
+    }
+
+    // Simple boundary check (800x600 game area) - only for players
+    for (auto& pair : _playerEntities) {
+        std::size_t i = static_cast<std::size_t>(pair.second);
+        Position* moved = integrate(pair.second);
+        if (!moved) continue;
+
+        auto& pos = *moved;
+        auto& vel = velocities->get_ref(i).value();
+        if (pos.x < 0) pos.x = 0;
+        if (pos.x > WORLD_WIDTH) pos.x = WORLD_WIDTH;
+        if (pos.y < 0) pos.y = 0;
+        if (pos.y > WORLD_HEIGHT) pos.y = WORLD_HEIGHT;
+
+        if (!_terrain.empty() && drawables && drawables->has(i)) {
+            keepOutOfTerrain(pos, pos.x - vel.vx * deltaTime, pos.y - vel.vy * deltaTime,
+                             drawables->get_ref(i).value());
+        }
+    }
+}
+
+void GameWorld::advanceScroll() {
+    if (_terrain.empty()) {
+        return;
+    }
+    // The level repeats: keep the offset small so it stays precise
+    _scrollX = std::fmod(_scrollX + SCROLL_SPEED * _tickInterval, _terrain.width());
+}
+
+void GameWorld::keepOutOfTerrain(Position& pos, float oldX, float oldY, const Drawable& draw) const {
+    auto blocked = [&](float x, float y) {
+        return _terrain.overlaps(AABB::fromRect(x + _scrollX, y, draw.width, draw.height));
+    };
+    if (!blocked(pos.x, pos.y)) {
+        return;
+    }
+    // The scroll carries the terrain left: staying where the player was in
+    // the level means being pushed back by one scroll step
+    const float heldX = oldX - SCROLL_SPEED * _tickInterval;
+    // Slide along the wall on the free axis, or get pushed
+    if (!blocked(pos.x, oldY)) {
+        pos.y = oldY;
+    } else if (!blocked(heldX, pos.y)) {
+        pos.x = heldX;
+    } else if (!blocked(heldX, oldY)) {
+        pos.x = heldX;
+        pos.y = oldY;
+    }
+    // Otherwise the player was already inside (pinned against the screen
+    // edge): let it move out
+    if (pos.x < 0) pos.x = 0;
+}
+
+// Terrain queries from world boxes. Positions are integrated and the scroll
+// advanced: the box started the tick one scroll step earlier in map space.
+bool GameWorld::sweepTerrain(const AABB& start, float dx, float dy, float& toi) const {
+    const float step = SCROLL_SPEED * _tickInterval;
+    const float offset = _scrollX - step;
+    AABB mapStart{start.minX + offset, start.minY, start.maxX + offset, start.maxY};
+    return _terrain.sweep(mapStart, dx + step, dy, toi);
+}
+
+bool GameWorld::hitsTerrain(const AABB& box) const {
+    return _terrain.overlaps(AABB{box.minX + _scrollX, box.minY, box.maxX + _scrollX, box.maxY});
+}
+
+bool GameWorld::levelScroll(LevelScrollPayload& out) const {
+    if (_levelId == 0) {
+        return false;
+    }
+    out.levelId = _levelId;
+    out.scrollX = _scrollX;
+    out.scrollSpeed = SCROLL_SPEED;
+    return true;
+}
+
+void GameWorld::rebuildFlowField() {
+    auto* positions = _registry.get_components_if<Position>();
+    auto* drawables = _registry.get_components_if<Drawable>();
+
+    // Player centers, as for the AIMED emitters
+    _flowTargets.clear();
+    if (positions && drawables) {
+        for (auto& pair : _playerEntities) {
+            size_t idx = static_cast<size_t>(pair.second);
+            auto& pos_opt = positions->get_ref(idx);
+            auto& draw_opt = drawables->get_ref(idx);
+            if (!pos_opt || !draw_opt) continue;
+            _flowTargets.push_back(FlowField::Target{pos_opt.value().x + draw_opt.value().width * 0.5f,
+                                                     pos_opt.value().y + draw_opt.value().height * 0.5f});
+        }
+    }
+    _flowField.build(_flowTargets);
+}
+
+void GameWorld::updateHoming() {
+    if (_homingEntities.size() == 0 || _flowField.empty()) {
+        return;
+    }
+
+    auto& positions = _registry.get_components<Position>();
+    auto& velocities = _registry.get_components<Velocity>();
+    auto& drawables = _registry.get_components<Drawable>();
+    auto& homings = _registry.get_components<Homing>();
+
+    // One cell lookup per entity, then turn the heading towards the cell's
+    // direction by at most turnRate * dt
+    for (auto entity : _homingEntities) {
+        size_t idx = static_cast<size_t>(entity);
+        auto& pos_opt = positions.get_ref(idx);
+        auto& vel_opt = velocities.get_ref(idx);
+        auto& draw_opt = drawables.get_ref(idx);
+        auto& homing_opt = homings.get_ref(idx);
+        if (!pos_opt || !vel_opt || !draw_opt || !homing_opt) continue;
+
+        const Homing& homing = homing_opt.value();
+        float dirX, dirY;
+        if (!_flowField.sample(pos_opt.value().x + draw_opt.value().width * 0.5f,
+                               pos_opt.value().y + draw_opt.value().height * 0.5f, dirX, dirY)) {
+            continue;  // On top of a player: keep the current heading
+        }
+
+        auto& vel = vel_opt.value();
+        float heading = std::atan2(vel.vy, vel.vx);
+        float turn = std::atan2(dirY, dirX) - heading;
+        if (turn > PI) turn -= 2.0f * PI;
+        if (turn < -PI) turn += 2.0f * PI;
+        const float maxTurn = homing.turnRate * _tickInterval;
+        heading += std::clamp(turn, -maxTurn, maxTurn);
+        vel = Velocity{std::cos(heading) * homing.speed, std::sin(heading) * homing.speed};
+    }
+}
+
+void GameWorld::fillSnapshot(std::vector<EntityBatchEntry>& out) {
+    // Get component storages
+    auto* positions = _registry.get_components_if<Position>();
+    auto* networkIds = _registry.get_components_if<NetworkId>();
+    auto* healths = _registry.get_components_if<Health>();
+    auto* curves = _registry.get_components_if<MotionCurve>();
+
+    if (!positions || !networkIds) {
+        return;
+    }
+
+    // Walk the groups rather than the whole storage: the pools' idle
+    // projectiles are skipped for free
+    auto makeEntry = [&](Entity entity, EntityBatchEntry& entry) {
+        size_t i = static_cast<size_t>(entity);
+        auto& pos_opt = positions->get_ref(i);
+        auto& netId_opt = networkIds->get_ref(i);
+
+        if (!pos_opt || !netId_opt) return false;
+        if (curves && curves->has(i)) return false;
+
+        auto& pos = pos_opt.value();
+        auto& netId = netId_opt.value();
+
+        // Get health if available, default to 100
+        uint8_t health = 100;
+        if (healths) {
+            auto& health_opt = healths->get_ref(i);
+            if (health_opt) {
+                health = health_opt.value().current;
+            }
+        }
+
+        entry.networkId = netId.id;
+        entry.posX = pos.x;
+        entry.posY = pos.y;
+        entry.health = health;
+        return true;
+    };
+    auto append = [&](Entity entity) {
+        EntityBatchEntry entry;
+        if (makeEntry(entity, entry)) {
+            out.push_back(entry);
+        }
+    };
+
+    for (auto& pair : _playerEntities) append(pair.second);
+    for (auto enemy : _enemyEntities) append(enemy);
+    for (auto bullet : _bulletEntities) append(bullet);
+
+    // Enemy bullets, strip by strip: each strip fills its own slice (on the
+    // worker pool when there are many), then the slices are closed up
+    std::size_t end = out.size();
+    for (auto& strip : _bulletStrips) {
+        strip.snapshotFirst = end;
+        end += strip.bullets.size();
+    }
+    out.resize(end);
+    runStrips([&](std::size_t index) {
+        BulletStrip& strip = _bulletStrips[index];
+        EntityBatchEntry* slice = out.data() + strip.snapshotFirst;
+        strip.snapshotCount = 0;
+        for (auto bullet : strip.bullets) {
+            if (makeEntry(bullet, slice[strip.snapshotCount])) {
+                ++strip.snapshotCount;
+            }
+        }
+    });
+
+    end = _bulletStrips.empty() ? out.size() : _bulletStrips.front().snapshotFirst;
+    for (auto& strip : _bulletStrips) {
+        if (strip.snapshotFirst != end) {
+            std::memmove(out.data() + end, out.data() + strip.snapshotFirst,
+                         strip.snapshotCount * sizeof(EntityBatchEntry));
+        }
+        end += strip.snapshotCount;
+    }
+    out.resize(end);
+}
+
+uint64_t GameWorld::checksum() {
+    auto* positions = _registry.get_components_if<Position>();
+    auto* velocities = _registry.get_components_if<Velocity>();
+    auto* networkIds = _registry.get_components_if<NetworkId>();
+    auto* healths = _registry.get_components_if<Health>();
+
+    // FNV-1a over the raw bytes: floats must match bit for bit
+    auto feed = [](uint64_t hash, const void* data, std::size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+        }
+        return hash;
+    };
+
+    // Entities are summed, so the hash does not depend on the order of the
+    // groups (the enemy bullet strips depend on the pool size)
+    uint64_t entities = 0;
+    auto add = [&](Entity entity) {
+        size_t i = static_cast<size_t>(entity);
+        uint64_t hash = 0xCBF29CE484222325ull;
+        if (networkIds && networkIds->has(i)) hash = feed(hash, &networkIds->get_ref(i).value().id, sizeof(uint32_t));
+        if (positions && positions->has(i)) {
+            const Position& pos = positions->get_ref(i).value();
+            hash = feed(hash, &pos.x, sizeof(float));
+            hash = feed(hash, &pos.y, sizeof(float));
+        }
+        if (velocities && velocities->has(i)) {
+            const Velocity& vel = velocities->get_ref(i).value();
+            hash = feed(hash, &vel.vx, sizeof(float));
+            hash = feed(hash, &vel.vy, sizeof(float));
+        }
+        if (healths && healths->has(i)) hash = feed(hash, &healths->get_ref(i).value().current, sizeof(uint8_t));
+        entities += deriveSeed(hash, 0);
+    };
+    for (auto& pair : _playerEntities) add(pair.second);
+    for (auto enemy : _enemyEntities) add(enemy);
+    for (auto bullet : _bulletEntities) add(bullet);
+    for (auto bullet : _enemyBulletEntities) add(bullet);
+
+    uint64_t tick = _timers.now();
+    uint64_t hash = 0xCBF29CE484222325ull;
+    hash = feed(hash, &tick, sizeof(tick));
+    hash = feed(hash, &_scrollX, sizeof(_scrollX));
+    hash = feed(hash, &_nextNetworkId, sizeof(_nextNetworkId));
+    hash = feed(hash, &entities, sizeof(entities));
+    return hash;
+}
+
+void GameWorld::setSpatialSortPeriod(float seconds) {
+    _spatialSortTicks = seconds > 0.0f ? std::max<uint64_t>(1, secondsToTicks(seconds)) : 0;
+}
+
+void GameWorld::sortBySpace() {
+    sortGroupBySpace(_bulletEntities, false);
+    sortGroupBySpace(_enemyBulletEntities, true);
+}
+
+void GameWorld::sortGroupBySpace(EntitySet& group, bool stripped) {
+    if (group.size() < 2) {
+        return;
+    }
+    auto& positions = _registry.get_components<Position>();
+
+    // Morton order of the projectiles (ties by ID: code and ID packed in one
+    // key), and the same IDs in ascending order: the k-th projectile of the
+    // first moves to the k-th ID of the second. Off-screen margin included:
+    // bullets enter from outside.
+    const float origin = -ENEMY_BULLET_MARGIN - 100.0f;
+    _sortKeys.clear();
+    for (Entity entity : group) {
+        const Position& pos = positions.get_ref(static_cast<size_t>(entity)).value();
+        uint64_t code = mortonCode(pos.x, pos.y, origin, origin, SPATIAL_SORT_CELL_SIZE);
+        _sortKeys.push_back(code << 32 | static_cast<uint32_t>(entity));
+    }
+    std::sort(_sortKeys.begin(), _sortKeys.end());
+    _sortFrom.clear();
+    _sortHoming.clear();
+    for (uint64_t key : _sortKeys) {
+        Entity entity = _registry.entity_from_index(static_cast<uint32_t>(key));
+        _sortFrom.push_back(entity);
+        _sortHoming.push_back(_homingEntities.contains(entity) ? 1 : 0);
+    }
+    _sortTo.assign(group.begin(), group.end());
+    std::sort(_sortTo.begin(), _sortTo.end());
+
+    // Every component a pooled projectile can carry (see the pool builders)
+    permuteComponents<Position, Velocity, Drawable, NetworkId, PlayerOwner, EntityTypeTag, Damage, Lifetime,
+                      Homing, LagCompensation>(_registry, _sortFrom, _sortTo);
+
+    // Timers target entity indices
+    auto retarget = [this](uint64_t handle, Entity entity) {
+        if (GameTimer* timer = _timers.find(handle)) {
+            timer->target = static_cast<uint32_t>(entity);
+        }
+    };
+    auto* lifetimes = _registry.get_components_if<Lifetime>();
+    auto* homings = _registry.get_components_if<Homing>();
+    for (Entity entity : _sortTo) {
+        size_t i = static_cast<size_t>(entity);
+        if (lifetimes && lifetimes->has(i)) retarget(lifetimes->get_ref(i).value().timer, entity);
+        if (homings && homings->has(i)) retarget(homings->get_ref(i).value().timer, entity);
+    }
+
+    // Sets follow their projectiles, rebuilt in ascending ID order so they
+    // walk the storage front to back (until new members are appended)
+    for (Entity entity : _sortFrom) {
+        _homingEntities.erase(entity);
+    }
+    group.clear();
+    for (std::size_t k = 0; k < _sortTo.size(); ++k) {
+        group.insert(_sortTo[k]);
+        if (_sortHoming[k]) _homingEntities.insert(_sortTo[k]);
+    }
+    if (stripped) {
+        for (auto& strip : _bulletStrips) {
+            strip.bullets.clear();
+        }
+        for (Entity bullet : _sortTo) {
+            float y = positions.get_ref(static_cast<size_t>(bullet)).value().y;
+            _bulletStrips[bulletStrip(y)].bullets.insert(bullet);
+        }
+    }
+}
+
+void GameWorld::applyPlayerInput(uint8_t playerId, int8_t moveX, int8_t moveY, uint8_t buttons,
+                                 uint32_t rewindTicks) {
+    // Find player entity
+    auto it = _playerEntities.find(playerId);
+    if (it == _playerEntities.end()) {
+        std::cerr << "[GameWorld] WARNING: Received input for unknown player " << (int)playerId << std::endl;
+        return;
+    }
+
+    Entity playerEntity = it->second;
+
+    // Set to true for verbose input logging (one line per non-idle input)
+    static const bool VERBOSE_LOGGING = false;
+    if (VERBOSE_LOGGING && (moveX != 0 || moveY != 0 || buttons != 0)) {
+        std::cout << "[GameWorld] Player " << (int)playerId
+                  << " input: move(" << (int)moveX << "," << (int)moveY << ")"
+                  << " buttons=" << (int)buttons
+                  << " entity=" << static_cast<size_t>(playerEntity) << std::endl;
+    }
+
+    // Get velocity component storage
+    auto* velocities = _registry.get_components_if<Velocity>();
+    if (!velocities) {
+        return;
+    }
+
+    // Update velocity based on input
+    auto& vel_opt = velocities->get_ref(static_cast<size_t>(playerEntity));
+    if (vel_opt) {
+        auto& vel = vel_opt.value();
+
+        // Apply movement (speed of 200 pixels per second)
+        const float PLAYER_SPEED = 200.0f;
+        vel.vx = moveX * PLAYER_SPEED;
+        vel.vy = moveY * PLAYER_SPEED;
+    }
+
+    // Handle shooting button
+    const uint8_t BTN_SHOOT = 0x01;
+    if (buttons & BTN_SHOOT) {
+        spawnBullet(playerId, playerEntity, std::min(rewindTicks, _maxRewindTicks));
+    }
+}
+
+void GameWorld::spawnPlayer(uint8_t playerId, const std::string& username) {
+    if (_playerEntities.count(playerId)) {
+        return;
+    }
+
+    // Spawn a player entity
+    Entity playerEntity = _registry.spawn_entity();
+    std::cout << "[GameWorld] Created entity ID=" << static_cast<size_t>(playerEntity)
+              << " for player " << (int)playerId << std::endl;
+
+    // Add components
+    float startX = 100.0f + playerId * 100.0f;  // Spread players horizontally
+    float startY = 300.0f;
+
+    _registry.add_component<Position>(playerEntity, Position{startX, startY});
+    _registry.add_component<Velocity>(playerEntity, Velocity{0.0f, 0.0f});
+
+    // Different color for each player
+    Color playerColors[] = {
+        Color{200, 30, 30},    // Red
+        Color{30, 200, 30},    // Green
+        Color{30, 30, 200},    // Blue
+        Color{200, 200, 30}    // Yellow
+    };
+    Color color = playerColors[(playerId - 1) % 4];
+    _registry.add_component<Drawable>(playerEntity, Drawable{48.0f, 48.0f, color});
+
+    _registry.add_component<NetworkId>(playerEntity, NetworkId{_nextNetworkId++});
+    _registry.add_component<PlayerOwner>(playerEntity, PlayerOwner{playerId});
+    _registry.add_component<Health>(playerEntity, Health{100, 100});
+    _registry.add_component<EntityTypeTag>(playerEntity, EntityTypeTag{EntityTypeTag::PLAYER});
+
+    // Store mapping. No spawn event: the server announces the player once
+    // its UDP endpoint is known (see playerSpawn)
+    _playerEntities.insert({ playerId, playerEntity });
+    _playerNames[playerId] = username;
+}
+
+void GameWorld::removePlayer(uint8_t playerId) {
+    _playerNames.erase(playerId);
+
+    auto it = _playerEntities.find(playerId);
+    if (it == _playerEntities.end()) {
+        return;
+    }
+
+    Entity playerEntity = it->second;
+
+    auto cooldown = _shotCooldowns.find(playerId);
+    if (cooldown != _shotCooldowns.end()) {
+        _timers.cancel(cooldown->second);
+        _shotCooldowns.erase(cooldown);
+    }
+
+    // Get network ID before destroying
+    auto* networkIds = _registry.get_components_if<NetworkId>();
+    uint32_t networkId = 0;
+
+    if (networkIds) {
+        auto& netId_opt = networkIds->get_ref(static_cast<size_t>(playerEntity));
+        if (netId_opt) {
+            networkId = netId_opt.value().id;
+        }
+    }
+
+    // Destroy entity
+    _registry.kill_entity(playerEntity);
+    _playerEntities.erase(it);
+
+    std::cout << "[GameWorld] Destroyed entity for player " << (int)playerId << std::endl;
+
+    emitDestroy(networkId);
+}
+
+bool GameWorld::makeSpawn(Entity entity, EntitySpawnPayload& out) {
+    size_t idx = static_cast<size_t>(entity);
+    auto* networkIds = _registry.get_components_if<NetworkId>();
+    auto* positions = _registry.get_components_if<Position>();
+    auto* velocities = _registry.get_components_if<Velocity>();
+    auto* healths = _registry.get_components_if<Health>();
+    auto* types = _registry.get_components_if<EntityTypeTag>();
+    auto* playerOwners = _registry.get_components_if<PlayerOwner>();
+
+    if (!networkIds || !positions || !velocities || !types || !playerOwners) {
+        return false;
+    }
+
+    auto& netId_opt = networkIds->get_ref(idx);
+    auto& pos_opt = positions->get_ref(idx);
+    auto& vel_opt = velocities->get_ref(idx);
+    auto& type_opt = types->get_ref(idx);
+    auto& owner_opt = playerOwners->get_ref(idx);
+
+    if (!netId_opt || !pos_opt || !vel_opt || !type_opt || !owner_opt) {
+        return false;
+    }
+
+    out.networkId = netId_opt.value().id;
+    out.entityType = type_opt.value().type;
+    out.ownerPlayer = owner_opt.value().playerId;
+    out.posX = pos_opt.value().x;
+    out.posY = pos_opt.value().y;
+    out.velocityX = vel_opt.value().vx;
+    out.velocityY = vel_opt.value().vy;
+
+    // Projectiles have no Health
+    out.health = 1;
+    if (healths) {
+        auto& health_opt = healths->get_ref(idx);
+        if (health_opt) {
+            out.health = health_opt.value().current;
+        }
+    }
+
+    // Username for PLAYER entities only
+    std::memset(out.username, 0, sizeof(out.username));
+    if (type_opt.value().type == EntityTypeTag::PLAYER) {
+        auto name = _playerNames.find(owner_opt.value().playerId);
+        if (name != _playerNames.end()) {
+            std::strncpy(out.username, name->second.c_str(), sizeof(out.username) - 1);
+        }
+    }
+    return true;
+}
+
+bool GameWorld::makeCurve(Entity entity, EntityCurvePayload& out) {
+    auto* curves = _registry.get_components_if<MotionCurve>();
+    auto* networkIds = _registry.get_components_if<NetworkId>();
+    size_t idx = static_cast<size_t>(entity);
+    if (!curves || !networkIds || !curves->has(idx) || !networkIds->has(idx)) {
+        return false;
+    }
+
+    const MotionCurve& curve = curves->get_ref(idx).value();
+    out.networkId = networkIds->get_ref(idx).value().id;
+    out.curveType = curve.type;
+    out.originX = curve.originX;
+    out.originY = curve.originY;
+    out.elapsed = static_cast<float>(_timers.now() - curve.startTick) * _tickInterval;
+    std::memcpy(out.params, curve.p, sizeof(out.params));
+    return true;
+}
+
+void GameWorld::collectSpawns(std::vector<EntitySpawnPayload>& spawns, std::vector<EntityCurvePayload>& curves) {
+    EntitySpawnPayload spawn;
+    EntityCurvePayload curve;
+    for (auto& pair : _playerEntities) {
+        if (makeSpawn(pair.second, spawn)) spawns.push_back(spawn);
+    }
+    for (auto enemy : _enemyEntities) {
+        if (makeSpawn(enemy, spawn)) spawns.push_back(spawn);
+        if (makeCurve(enemy, curve)) curves.push_back(curve);
+    }
+    for (auto bullet : _bulletEntities) {
+        if (makeSpawn(bullet, spawn)) spawns.push_back(spawn);
+    }
+    for (auto bullet : _enemyBulletEntities) {
+        if (makeSpawn(bullet, spawn)) spawns.push_back(spawn);
+    }
+}
+
+bool GameWorld::playerSpawn(uint8_t playerId, EntitySpawnPayload& out) {
+    auto it = _playerEntities.find(playerId);
+    return it != _playerEntities.end() && makeSpawn(it->second, out);
+}
+
+void GameWorld::emitSpawn(Entity entity) {
+    WorldEvent event;
+    event.kind = WorldEvent::SPAWN;
+    if (makeSpawn(entity, event.spawn)) {
+        _events.push_back(event);
+    }
+}
+
+void GameWorld::emitDestroy(uint32_t networkId) {
+    if (networkId == 0) {
+        return;
+    }
+    WorldEvent event;
+    event.kind = WorldEvent::DESTROY;
+    event.destroy.networkId = networkId;
+    _events.push_back(event);
+}
+
+void GameWorld::emitCurve(Entity entity) {
+    WorldEvent event;
+    event.kind = WorldEvent::CURVE;
+    event.curve = EntityCurvePayload{};
+    if (makeCurve(entity, event.curve)) {
+        _events.push_back(event);
+    }
+}
+
+void GameWorld::emitLevel() {
+    WorldEvent event;
+    event.kind = WorldEvent::LEVEL;
+    if (levelScroll(event.level)) {
+        _events.push_back(event);
+    }
+}
+
+void GameWorld::emitUpdate(Entity entity) {
+    size_t idx = static_cast<size_t>(entity);
+    auto* networkIds = _registry.get_components_if<NetworkId>();
+    auto* positions = _registry.get_components_if<Position>();
+    auto* velocities = _registry.get_components_if<Velocity>();
+    auto* healths = _registry.get_components_if<Health>();
+    if (!networkIds || !positions || !velocities || !healths) return;
+    if (!networkIds->has(idx) || !positions->has(idx) || !velocities->has(idx) || !healths->has(idx)) return;
+
+    WorldEvent event;
+    event.kind = WorldEvent::UPDATE;
+    event.update = EntityUpdatePayload{};
+    event.update.networkId = networkIds->get_ref(idx).value().id;
+    event.update.posX = positions->get_ref(idx).value().x;
+    event.update.posY = positions->get_ref(idx).value().y;
+    event.update.velocityX = velocities->get_ref(idx).value().vx;
+    event.update.velocityY = velocities->get_ref(idx).value().vy;
+    event.update.health = healths->get_ref(idx).value().current;
+    _events.push_back(event);
+}
+
+// Gameplay systems implementation
+
+void GameWorld::buildPlayerBullet(registry& reg, Entity bullet) {
+    // Parked off-screen until the pool hands it out
+    reg.add_component<Position>(bullet, Position{-1000.0f, -1000.0f});
+    reg.add_component<Velocity>(bullet, Velocity{0.0f, 0.0f});
+    reg.add_component<Drawable>(bullet, Drawable{8.0f, 2.0f, Color{255, 255, 0}});  // Yellow bullet (thin)
+    reg.add_component<NetworkId>(bullet, NetworkId{0});
+    reg.add_component<PlayerOwner>(bullet, PlayerOwner{0});
+    reg.add_component<EntityTypeTag>(bullet, EntityTypeTag{EntityTypeTag::BULLET_PLAYER});
+    reg.add_component<Damage>(bullet, Damage{25});
+    reg.add_component<Lifetime>(bullet, Lifetime{3.0f});
+    reg.add_component<LagCompensation>(bullet, LagCompensation{0});
+}
+
+void GameWorld::buildEnemyBullet(registry& reg, Entity bullet) {
+    reg.add_component<Position>(bullet, Position{-1000.0f, -1000.0f});
+    reg.add_component<Velocity>(bullet, Velocity{0.0f, 0.0f});
+    reg.add_component<Drawable>(bullet, Drawable{ENEMY_BULLET_SIZE, ENEMY_BULLET_SIZE, Color{255, 0, 0}});  // Red bullet
+    reg.add_component<NetworkId>(bullet, NetworkId{0});
+    reg.add_component<PlayerOwner>(bullet, PlayerOwner{0});  // Server-owned
+    reg.add_component<EntityTypeTag>(bullet, EntityTypeTag{EntityTypeTag::BULLET_ENEMY});
+    reg.add_component<Damage>(bullet, Damage{10});
+    reg.add_component<Lifetime>(bullet, Lifetime{6.0f});
+    reg.add_component<Homing>(bullet, Homing{});  // Only steers while in _homingEntities
+}
+
+void GameWorld::spawnBullet(uint8_t playerId, Entity playerEntity, uint32_t rewindTicks) {
+    // Simple rate limiting: a player can't shoot while its cooldown timer is pending
+    if (_shotCooldowns.count(playerId)) {
+        return;  // Too soon, ignore
+    }
+
+    _shotCooldowns[playerId] = _timers.schedule(secondsToTicks(SHOOT_COOLDOWN),
+                                                GameTimer{GameTimer::SHOT_COOLDOWN, playerId});
+
+    // Get player position
+    auto* positions = _registry.get_components_if<Position>();
+    if (!positions) return;
+
+    auto& pos_opt = positions->get_ref(static_cast<size_t>(playerEntity));
+    if (!pos_opt) return;
+
+    // Spawn bullet slightly in front of player. Copied before acquire(): a
+    // growing pool adds components, which can move the storages
+    float bulletX = pos_opt.value().x + 60.0f;  // Offset to the right
+    float bulletY = pos_opt.value().y + 20.0f;  // Center of player
+
+    // Take a pre-built bullet entity from the pool
+    Entity bullet = _playerBullets.acquire();
+    size_t bulletIdx = static_cast<size_t>(bullet);
+
+    // Reset the per-shot state only; the other components were set by the pool.
+    // A fresh network ID makes clients see a new entity, not the recycled one.
+    positions->get_ref(bulletIdx) = Position{bulletX, bulletY};
+    _registry.get_components<Velocity>().get_ref(bulletIdx) = Velocity{400.0f, 0.0f};  // Fast moving right
+    _registry.get_components<NetworkId>().get_ref(bulletIdx) = NetworkId{_nextNetworkId++};
+    _registry.get_components<PlayerOwner>().get_ref(bulletIdx) = PlayerOwner{playerId};
+    _registry.get_components<LagCompensation>().get_ref(bulletIdx) =
+        LagCompensation{static_cast<uint16_t>(rewindTicks)};
+    auto& lifetime = _registry.get_components<Lifetime>().get_ref(bulletIdx).value();  // Despawn after 3 seconds
+    lifetime.timer = _timers.schedule(secondsToTicks(lifetime.duration),
+                                      GameTimer{GameTimer::ENTITY_EXPIRE, static_cast<uint32_t>(bullet)});
+
+    _bulletEntities.insert(bullet);
+    emitSpawn(bullet);
+}
+
+Entity GameWorld::spawnEnemy(const MotionCurve& path, const Emitter& emitter) {
+    Entity enemy = _registry.spawn_entity();
+
+    // The curve starts now, at f(0)
+    MotionCurve& curve = _registry.add_component<MotionCurve>(enemy, MotionCurve{path});
+    curve.startTick = _timers.now();
+    float startX, startY;
+    evaluateCurve(curve, 0.0f, startX, startY);
+    _curves.add(enemy, curve);
+
+    // Velocity is set by the curve system
+    addEnemyComponents(enemy, startX, startY, 0.0f, 0.0f, emitter);
+
+    _enemyEntities.insert(enemy);
+    emitSpawn(enemy);
+    emitCurve(enemy);
+    return enemy;
+}
+
+Entity GameWorld::spawnHomingEnemy(float x, float y, const Homing& homing, const Emitter& emitter) {
+    Entity enemy = _registry.spawn_entity();
+
+    // Enters heading left, then steers towards the players
+    addEnemyComponents(enemy, x, y, -homing.speed, 0.0f, emitter);
+    Homing& stored = _registry.add_component<Homing>(enemy, Homing{homing});
+    if (stored.duration > 0.0f) {
+        stored.timer = _timers.schedule(secondsToTicks(stored.duration),
+                                        GameTimer{GameTimer::HOMING_END, static_cast<uint32_t>(enemy)});
+    }
+
+    _enemyEntities.insert(enemy);
+    _homingEntities.insert(enemy);
+    emitSpawn(enemy);
+    return enemy;
+}
+
+void GameWorld::addEnemyComponents(Entity enemy, float x, float y, float vx, float vy, const Emitter& emitter) {
+    _registry.add_component<Position>(enemy, Position{x, y});
+    _registry.add_component<Velocity>(enemy, Velocity{vx, vy});
+    _registry.add_component<Drawable>(enemy, Drawable{40.0f, 40.0f, Color{255, 0, 0}});  // Red enemy
+    _registry.add_component<NetworkId>(enemy, NetworkId{_nextNetworkId++});
+    _registry.add_component<PlayerOwner>(enemy, PlayerOwner{0});  // Server-owned
+    _registry.add_component<EntityTypeTag>(enemy, EntityTypeTag{EntityTypeTag::ENEMY});
+    _registry.add_component<Health>(enemy, Health{50, 50});
+
+    // First volley after one interval, then the emitter reschedules itself
+    Emitter& pattern = _registry.add_component<Emitter>(enemy, Emitter{emitter});
+    pattern.timer = _timers.schedule(secondsToTicks(pattern.interval),
+                                     GameTimer{GameTimer::EMITTER_FIRE, static_cast<uint32_t>(enemy)});
+}
+
+MotionCurve GameWorld::randomPath(float x, float y) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    float sign = unit(_pathRng) < 0.5f ? -1.0f : 1.0f;
+
+    // Every path drifts left and leaves the screen, like the former
+    // constant Velocity{-150, 0}
+    MotionCurve path;
+    switch (std::uniform_int_distribution<int>(0, MotionCurve::TYPE_COUNT - 1)(_pathRng)) {
+        case MotionCurve::LINE:
+            path = MotionCurve{MotionCurve::LINE, x, y};
+            path.p[0] = -150.0f;
+            break;
+        case MotionCurve::SINE:
+            path = MotionCurve{MotionCurve::SINE, x, y};
+            path.p[0] = -120.0f;
+            path.p[1] = 40.0f + 60.0f * unit(_pathRng);   // amplitude
+            path.p[2] = 0.3f + 0.4f * unit(_pathRng);     // Hz
+            break;
+        case MotionCurve::CIRCLE:
+            path = MotionCurve{MotionCurve::CIRCLE, x, y};
+            path.p[0] = -100.0f;
+            path.p[2] = 40.0f + 40.0f * unit(_pathRng);   // radius
+            path.p[3] = sign * 2.5f;                  // rad/s
+            path.p[4] = curves::TWO_PI * unit(_pathRng);
+            break;
+        default:
+            // Swoop towards the middle of the screen and back out
+            path = MotionCurve{MotionCurve::BEZIER, x, y};
+            path.p[0] = -350.0f;
+            path.p[1] = sign * 250.0f;
+            path.p[2] = -650.0f;
+            path.p[3] = -sign * 250.0f;
+            path.p[4] = -1000.0f;
+            path.p[5] = 0.0f;
+            path.p[6] = 6.0f;
+            break;
+    }
+
+    // Keep the whole path on screen vertically (sine amplitude, circle radius)
+    float margin = path.type == MotionCurve::SINE ? path.p[1] : path.type == MotionCurve::CIRCLE ? path.p[2] : 0.0f;
+    path.originY = std::min(std::max(y, margin), WORLD_HEIGHT - 40.0f - margin);
+    return path;
+}
+
+void GameWorld::spawnRandomEnemy() {
+    // Spawn at random Y position on the right edge
+    std::uniform_real_distribution<float> yDist(0.0f, 600.0f);
+    float enemyX = 850.0f;  // Just off right edge
+    float enemyY = yDist(_spawnRng);
+
+    // One of the four patterns, tuned to stay dodgeable
+    Emitter emitter;
+    switch (std::uniform_int_distribution<int>(0, 3)(_enemyRng)) {
+        case 0:
+            emitter = Emitter{Emitter::RADIAL, 12, 120.0f, 1.5f};
+            break;
+        case 1:
+            emitter = Emitter{Emitter::SPIRAL, 3, 140.0f, 0.2f};
+            emitter.spin = 0.35f;
+            break;
+        case 2:
+            emitter = Emitter{Emitter::AIMED, 3, 180.0f, 1.2f};
+            emitter.spread = 0.4f;
+            break;
+        default:
+            emitter = Emitter{Emitter::HOMING, 2, 110.0f, 2.0f};
+            emitter.spread = 0.8f;
+            break;
+    }
+    emitter.angle = std::uniform_real_distribution<float>(0.0f, 2.0f * PI)(_enemyRng);
+
+    // One enemy in five chases the players for a while instead of following a path
+    if (std::uniform_int_distribution<int>(0, 4)(_enemyRng) == 0) {
+        spawnHomingEnemy(enemyX, enemyY, Homing{90.0f, 1.5f, 6.0f}, emitter);
+        std::cout << "[GameWorld] Spawned homing enemy at (" << enemyX << ", " << enemyY
+                  << ") with pattern " << (int)emitter.pattern << std::endl;
+        return;
+    }
+
+    MotionCurve path = randomPath(enemyX, enemyY);
+    spawnEnemy(path, emitter);
+
+    std::cout << "[GameWorld] Spawned enemy at (" << enemyX << ", " << path.originY
+              << ") with pattern " << (int)emitter.pattern << ", path " << (int)path.type << std::endl;
+}
+
+void GameWorld::fireEmitter(Entity owner) {
+    size_t idx = static_cast<size_t>(owner);
+    auto& emitters = _registry.get_components<Emitter>();
+    auto* positions = _registry.get_components_if<Position>();
+    auto* drawables = _registry.get_components_if<Drawable>();
+    if (!emitters.has(idx) || !positions || !drawables) return;
+
+    // Copies: spawning bullets can grow the pool, which moves the storages
+    Emitter emitter = emitters.get_ref(idx).value();
+    Position pos = positions->get_ref(idx).value();
+    Drawable draw = drawables->get_ref(idx).value();
+    float originX = pos.x + draw.width * 0.5f;
+    float originY = pos.y + draw.height * 0.5f;
+
+    switch (emitter.pattern) {
+        case Emitter::RADIAL:
+        case Emitter::SPIRAL: {
+            float step = 2.0f * PI / std::max<int>(1, emitter.count);
+            for (int k = 0; k < emitter.count; ++k) {
+                spawnEnemyBullet(originX, originY, emitter.angle + k * step, emitter.speed);
+            }
+            if (emitter.pattern == Emitter::SPIRAL) {
+                emitter.angle = std::fmod(emitter.angle + emitter.spin, 2.0f * PI);
+            }
+            break;
+        }
+        case Emitter::AIMED:
+        case Emitter::HOMING: {
+            // Straight left when nobody is connected. Homing bullets only
+            // need a rough start direction: their emitter's flow field cell
+            float base = PI;
+            float targetX, targetY;
+            float dirX, dirY;
+            float turnRate = 0.0f;
+            if (emitter.pattern == Emitter::HOMING) {
+                turnRate = HOMING_BULLET_TURN_RATE;
+                if (_flowField.sample(originX, originY, dirX, dirY)) {
+                    base = std::atan2(dirY, dirX);
+                }
+            } else if (nearestPlayer(originX, originY, targetX, targetY)) {
+                base = std::atan2(targetY - originY, targetX - originX);
+            }
+            if (emitter.count <= 1) {
+                spawnEnemyBullet(originX, originY, base, emitter.speed, turnRate);
+                break;
+            }
+            float step = emitter.spread / (emitter.count - 1);
+            for (int k = 0; k < emitter.count; ++k) {
+                spawnEnemyBullet(originX, originY, base - emitter.spread * 0.5f + k * step, emitter.speed, turnRate);
+            }
+            break;
+        }
+    }
+
+    Emitter& stored = emitters.get_ref(idx).value();
+    stored.angle = emitter.angle;
+    stored.timer = _timers.schedule(secondsToTicks(emitter.interval),
+                                    GameTimer{GameTimer::EMITTER_FIRE, static_cast<uint32_t>(owner)});
+}
+
+void GameWorld::spawnEnemyBullet(float x, float y, float angle, float speed, float turnRate) {
+    Entity bullet = _enemyBullets.acquire();
+    size_t bulletIdx = static_cast<size_t>(bullet);
+
+    const float half = ENEMY_BULLET_SIZE * 0.5f;
+    _registry.get_components<Position>().get_ref(bulletIdx) = Position{x - half, y - half};
+    _registry.get_components<Velocity>().get_ref(bulletIdx) =
+        Velocity{std::cos(angle) * speed, std::sin(angle) * speed};
+    _registry.get_components<NetworkId>().get_ref(bulletIdx) = NetworkId{_nextNetworkId++};
+    auto& lifetime = _registry.get_components<Lifetime>().get_ref(bulletIdx).value();
+    lifetime.timer = _timers.schedule(secondsToTicks(lifetime.duration),
+                                      GameTimer{GameTimer::ENTITY_EXPIRE, static_cast<uint32_t>(bullet)});
+
+    // Homing until its lifetime ends
+    if (turnRate > 0.0f) {
+        _registry.get_components<Homing>().get_ref(bulletIdx) = Homing{speed, turnRate};
+        _homingEntities.insert(bullet);
+    }
+
+    _enemyBulletEntities.insert(bullet);
+    _bulletStrips[bulletStrip(y - half)].bullets.insert(bullet);
+    emitSpawn(bullet);
+}
+
+bool GameWorld::nearestPlayer(float x, float y, float& targetX, float& targetY) {
+    auto* positions = _registry.get_components_if<Position>();
+    auto* drawables = _registry.get_components_if<Drawable>();
+    if (!positions || !drawables) return false;
+
+    float best = -1.0f;
+    for (auto& pair : _playerEntities) {
+        size_t idx = static_cast<size_t>(pair.second);
+        auto& pos_opt = positions->get_ref(idx);
+        auto& draw_opt = drawables->get_ref(idx);
+        if (!pos_opt || !draw_opt) continue;
+
+        float cx = pos_opt.value().x + draw_opt.value().width * 0.5f;
+        float cy = pos_opt.value().y + draw_opt.value().height * 0.5f;
+        float d2 = (cx - x) * (cx - x) + (cy - y) * (cy - y);
+        if (best < 0.0f || d2 < best) {
+            best = d2;
+            targetX = cx;
+            targetY = cy;
+        }
+    }
+    return best >= 0.0f;
+}
+
+void GameWorld::updateTimers() {
+    _timers.advance([this](const GameTimer& timer) { onTimer(timer); });
+}
+
+void GameWorld::onTimer(const GameTimer& timer) {
+    switch (timer.kind) {
+        case GameTimer::ENTITY_EXPIRE: {
+            // Timers are cancelled when their entity dies, so the index is still ours
+            auto* lifetimes = _registry.get_components_if<Lifetime>();
+            if (lifetimes && lifetimes->has(timer.target)) {
+                lifetimes->get_ref(timer.target).value().timer = 0;
+            }
+            destroyEntity(_registry.entity_from_index(timer.target));
+            break;
+        }
+        case GameTimer::ENEMY_SPAWN: {
+            spawnRandomEnemy();
+            // Random next spawn time between 3 and 5 seconds
+            std::uniform_real_distribution<float> dist(MIN_ENEMY_SPAWN_INTERVAL, MAX_ENEMY_SPAWN_INTERVAL);
+            _timers.schedule(secondsToTicks(dist(_spawnRng)), GameTimer{GameTimer::ENEMY_SPAWN, 0});
+            break;
+        }
+        case GameTimer::SHOT_COOLDOWN:
+            _shotCooldowns.erase(static_cast<uint8_t>(timer.target));
+            break;
+        case GameTimer::EMITTER_FIRE:
+            // Cancelled with the enemy as well (see destroyEntity)
+            fireEmitter(_registry.entity_from_index(timer.target));
+            break;
+        case GameTimer::CURVE_SYNC:
+            for (auto enemy : _enemyEntities) {
+                emitCurve(enemy);
+            }
+            // Clients scroll the terrain on their own clock: resync it too
+            emitLevel();
+            _timers.schedule(secondsToTicks(CURVE_SYNC_PERIOD), GameTimer{GameTimer::CURVE_SYNC, 0});
+            break;
+        case GameTimer::FLOW_FIELD:
+            rebuildFlowField();
+            _timers.schedule(secondsToTicks(FLOW_FIELD_PERIOD), GameTimer{GameTimer::FLOW_FIELD, 0});
+            break;
+        case GameTimer::HOMING_END: {
+            // Stop chasing and leave through the left edge (cancelled with the entity)
+            Entity entity = _registry.entity_from_index(timer.target);
+            auto& homing = _registry.get_components<Homing>().get_ref(timer.target).value();
+            homing.timer = 0;
+            _registry.get_components<Velocity>().get_ref(timer.target) = Velocity{-homing.speed, 0.0f};
+            _homingEntities.erase(entity);
+            break;
+        }
+    }
+}
+
+uint64_t GameWorld::secondsToTicks(float seconds) const {
+    return static_cast<uint64_t>(std::ceil(seconds * static_cast<float>(_tickRate)));
+}
+
+void GameWorld::checkCollisions() {
+    const float deltaTime = _tickInterval;
+
+    auto* positions = _registry.get_components_if<Position>();
+    auto* velocities = _registry.get_components_if<Velocity>();
+    auto* drawables = _registry.get_components_if<Drawable>();
+    auto* types = _registry.get_components_if<EntityTypeTag>();
+    auto* damages = _registry.get_components_if<Damage>();
+    auto* healths = _registry.get_components_if<Health>();
+    auto* compounds = _registry.get_components_if<CompoundCollider>();
+    auto* networkIds = _registry.get_components_if<NetworkId>();
+    auto* rewinds = _registry.get_components_if<LagCompensation>();
+
+    if (!positions || !velocities || !drawables || !types || !healths) return;
+
+    std::vector<Entity> toDestroy;
+
+    // Displacement of an entity over this tick (positions are already integrated)
+    auto displacement = [&](size_t idx, float& dx, float& dy) {
+        dx = 0.0f;
+        dy = 0.0f;
+        auto& vel_opt = velocities->get_ref(idx);
+        if (vel_opt) {
+            dx = vel_opt.value().vx * deltaTime;
+            dy = vel_opt.value().vy * deltaTime;
+        }
+    };
+
+    // Broadphase: gather enemy boxes once and bucket them into the grid.
+    // They are recorded as this tick's frame of the history, over the frame
+    // of the tick that left the rewind window.
+    const uint64_t now = _timers.now();
+    EnemyFrame& frame = enemyFrame(now);
+    frame.tick = now;
+    frame.colliders.clear();
+    frame.bounds.clear();
+    _enemyGrid.clear();
+    for (auto enemy : _enemyEntities) {
+        size_t enemyIdx = static_cast<size_t>(enemy);
+        auto& enemy_pos_opt = positions->get_ref(enemyIdx);
+        auto& enemy_draw_opt = drawables->get_ref(enemyIdx);
+        auto& enemy_health_opt = healths->get_ref(enemyIdx);
+
+        if (!enemy_pos_opt || !enemy_draw_opt || !enemy_health_opt) continue;
+
+        auto& enemyPos = enemy_pos_opt.value();
+        auto& enemyDraw = enemy_draw_opt.value();
+        float dx, dy;
+        displacement(enemyIdx, dx, dy);
+        float originX = enemyPos.x - dx;
+        float originY = enemyPos.y - dy;
+
+        const ColliderShape* shape = nullptr;
+        if (compounds && compounds->has(enemyIdx)) {
+            shape = compounds->get_ref(enemyIdx).value().shape.get();
+        }
+
+        AABB start;
+        if (shape) {
+            const AABB& local = shape->bounds();
+            start = AABB{originX + local.minX, originY + local.minY,
+                         originX + local.maxX, originY + local.maxY};
+        } else {
+            start = AABB::fromRect(originX, originY, enemyDraw.width, enemyDraw.height);
+        }
+
+        uint32_t networkId = 0;
+        if (networkIds && networkIds->has(enemyIdx)) {
+            networkId = networkIds->get_ref(enemyIdx).value().id;
+        }
+
+        AABB swept = sweptBounds(start, dx, dy);
+        _enemyGrid.insert(static_cast<uint32_t>(frame.colliders.size()), swept);
+        frame.bounds.push(swept);
+        frame.colliders.push_back(EnemyCollider{enemy, networkId, start, dx, dy, shape, originX, originY});
+    }
+    _enemyGrid.build();
+
+    // Check bullet vs enemy collisions
+    for (auto bullet : _bulletEntities) {
+        size_t bulletIdx = static_cast<size_t>(bullet);
+        auto& bullet_pos_opt = positions->get_ref(bulletIdx);
+        auto& bullet_draw_opt = drawables->get_ref(bulletIdx);
+        auto& bullet_type_opt = types->get_ref(bulletIdx);
+
+        if (!bullet_pos_opt || !bullet_draw_opt || !bullet_type_opt) continue;
+        if (bullet_type_opt.value().type != EntityTypeTag::BULLET_PLAYER) continue;
+
+        auto& bulletPos = bullet_pos_opt.value();
+        auto& bulletDraw = bullet_draw_opt.value();
+        float bdx, bdy;
+        displacement(bulletIdx, bdx, bdy);
+        AABB bulletStart = AABB::fromRect(bulletPos.x - bdx, bulletPos.y - bdy,
+                                          bulletDraw.width, bulletDraw.height);
+
+        // Fast movers (more than half their size per tick) are swept over the
+        // tick, otherwise the discrete test at end-of-tick positions is enough
+        bool fastMover = std::abs(bdx) * 2.0f > bulletDraw.width ||
+                         std::abs(bdy) * 2.0f > bulletDraw.height;
+
+        // Terrain stops the bullet unless it hits an enemy first
+        float terrainTime = 2.0f;
+        if (!_terrain.empty()) {
+            sweepTerrain(bulletStart, bdx, bdy, terrainTime);
+        }
+
+        // Get bullet damage
+        uint8_t bulletDamage = 25;
+        if (damages) {
+            auto& damage_opt = damages->get_ref(bulletIdx);
+            if (damage_opt) {
+                bulletDamage = damage_opt.value().amount;
+            }
+        }
+
+        // Lag-compensated shot: test it against the frame its shooter saw,
+        // while that frame is still in the history
+        const EnemyFrame* target = &frame;
+        uint32_t rewind = 0;
+        if (rewinds) {
+            auto& rewind_opt = rewinds->get_ref(bulletIdx);
+            if (rewind_opt) {
+                rewind = rewind_opt.value().rewindTicks;
+            }
+        }
+        if (rewind > 0 && rewind <= now) {
+            const EnemyFrame& past = enemyFrame(now - rewind);
+            if (past.tick == now - rewind) {
+                target = &past;
+            }
+        }
+
+        // A bullet can only hit one enemy: keep the earliest impact, ties
+        // going to the first enemy in spawn order.
+        uint32_t hitIndex = UINT32_MAX;
+        float hitTime = 2.0f;
+        auto narrowPhase = [&](uint32_t candidate) {
+            const EnemyCollider& enemy = target->colliders[candidate];
+            float toi = 1.0f;
+            bool hit;
+            if (enemy.shape) {
+                // Bounds overlap: refine against the hitboxes, in shape space
+                AABB localStart{bulletStart.minX - enemy.originX, bulletStart.minY - enemy.originY,
+                                bulletStart.maxX - enemy.originX, bulletStart.maxY - enemy.originY};
+                if (fastMover) {
+                    hit = enemy.shape->sweep(localStart, bdx - enemy.dx, bdy - enemy.dy, toi);
+                } else {
+                    // Both moved by their displacement: compare end positions
+                    float ox = bdx - enemy.dx;
+                    float oy = bdy - enemy.dy;
+                    hit = enemy.shape->overlaps(AABB{localStart.minX + ox, localStart.minY + oy,
+                                                     localStart.maxX + ox, localStart.maxY + oy});
+                }
+            } else if (fastMover) {
+                // Sweep the bullet relative to the (moving) enemy
+                hit = sweptAABB(bulletStart, bdx - enemy.dx, bdy - enemy.dy, enemy.box, toi);
+            } else {
+                AABB bulletEnd = AABB::fromRect(bulletPos.x, bulletPos.y, bulletDraw.width, bulletDraw.height);
+                AABB enemyEnd{enemy.box.minX + enemy.dx, enemy.box.minY + enemy.dy,
+                              enemy.box.maxX + enemy.dx, enemy.box.maxY + enemy.dy};
+                hit = aabbOverlap(bulletEnd, enemyEnd);
+            }
+            if (hit && (toi < hitTime || (toi == hitTime && candidate < hitIndex))) {
+                hitIndex = candidate;
+                hitTime = toi;
+            }
+        };
+
+        AABB bulletBounds = sweptBounds(bulletStart, bdx, bdy);
+        if (target == &frame) {
+            // Narrow phase only against enemies sharing a cell with the
+            // bullet: the batch kernel rejects enemies whose swept bounds
+            // miss the bullet's, the exact test only runs on the survivors
+            _enemyGrid.queryOverlaps(bulletBounds, narrowPhase);
+        } else {
+            // Past frame: every recorded enemy through the batch kernel,
+            // skipping those that died or whose entity was reused since
+            // (which also keeps their shape pointer valid)
+            std::size_t count = target->colliders.size();
+            _rewindHits.resize((count + 31) / 32);
+            if (count > 0 && overlapBatch(bulletBounds, target->bounds, 0, count, _rewindHits.data()) > 0) {
+                forEachHit(_rewindHits.data(), count, [&](std::size_t i) {
+                    const EnemyCollider& enemy = target->colliders[i];
+                    if (!_enemyEntities.contains(enemy.entity)) return;
+                    if (!networkIds || !networkIds->has(static_cast<size_t>(enemy.entity)) ||
+                        networkIds->get_ref(static_cast<size_t>(enemy.entity)).value().id != enemy.networkId) {
+                        return;
+                    }
+                    narrowPhase(static_cast<uint32_t>(i));
+                });
+            }
+        }
+
+        if (hitIndex == UINT32_MAX || hitTime > terrainTime) {
+            if (terrainTime <= 1.0f) {
+                toDestroy.push_back(bullet);
+            }
+        } else {
+            Entity enemy = target->colliders[hitIndex].entity;
+            auto& enemyHealth = healths->get_ref(static_cast<size_t>(enemy)).value();
+
+            // Apply damage. Enemies on a curve are not in the snapshots:
+            // their new health goes out as an ENTITY_UPDATE
+            if (enemyHealth.current > bulletDamage) {
+                enemyHealth.current -= bulletDamage;
+                if (_curves.contains(enemy)) {
+                    emitUpdate(enemy);
+                }
+            } else {
+                enemyHealth.current = 0;
+                toDestroy.push_back(enemy);
+            }
+
+            // Destroy bullet
+            toDestroy.push_back(bullet);
+        }
+    }
+
+    // Enemy bullets vs players, and enemy bullets leaving the screen
+    timed(_profile, TickProfile::ENEMY_BULLETS, [&] { checkEnemyBullets(toDestroy); });
+
+    // Destroy off-screen enemies (left edge)
+    for (auto enemy : _enemyEntities) {
+        size_t enemyIdx = static_cast<size_t>(enemy);
+        auto& enemy_pos_opt = positions->get_ref(enemyIdx);
+        if (!enemy_pos_opt) continue;
+
+        auto& enemyPos = enemy_pos_opt.value();
+        if (enemyPos.x < -100.0f) {  // Off left edge
+            toDestroy.push_back(enemy);
+        }
+    }
+
+    // Destroy off-screen bullets (right edge)
+    for (auto bullet : _bulletEntities) {
+        size_t bulletIdx = static_cast<size_t>(bullet);
+        auto& bullet_pos_opt = positions->get_ref(bulletIdx);
+        if (!bullet_pos_opt) continue;
+
+        auto& bulletPos = bullet_pos_opt.value();
+        if (bulletPos.x > 900.0f) {  // Off right edge
+            toDestroy.push_back(bullet);
+        }
+    }
+
+    // Remove duplicates
+    std::sort(toDestroy.begin(), toDestroy.end());
+    toDestroy.erase(std::unique(toDestroy.begin(), toDestroy.end()), toDestroy.end());
+
+    // Destroy all marked entities
+    for (auto entity : toDestroy) {
+        destroyEntity(entity);
+    }
+}
+
+void GameWorld::checkEnemyBullets(std::vector<Entity>& toDestroy) {
+    auto& positions = _registry.get_components<Position>();
+    auto& drawables = _registry.get_components<Drawable>();
+    auto& healths = _registry.get_components<Health>();
+
+    // One strip per share of the pool, unless this world is ticked on one of
+    // the pool's workers already (rooms ticked side by side)
+    std::size_t strips = 1;
+    if (_workers && _workers->size() > 1 && !_workers->inJob() &&
+        _enemyBulletEntities.size() >= PARALLEL_MIN_BULLETS) {
+        strips = _workers->size() * STRIPS_PER_THREAD;
+    }
+    if (strips != _bulletStrips.size()) {
+        splitBulletStrips(strips);
+    }
+
+    // Player boxes at their end-of-tick position, read by every strip
+    _stripPlayers.clear();
+    for (auto& pair : _playerEntities) {
+        size_t playerIdx = static_cast<size_t>(pair.second);
+        auto& pos_opt = positions.get_ref(playerIdx);
+        auto& draw_opt = drawables.get_ref(playerIdx);
+        if (!pos_opt || !draw_opt || !healths.has(playerIdx)) continue;
+
+        _stripPlayers.push_back(StripPlayer{pair.second, AABB::fromRect(pos_opt.value().x, pos_opt.value().y,
+                                                                        draw_opt.value().width,
+                                                                        draw_opt.value().height)});
+    }
+
+    runStrips([this](std::size_t index) { updateBulletStrip(index); });
+
+    // Serial fix-up, strip by strip in a fixed order
+    for (std::size_t index = 0; index < _bulletStrips.size(); ++index) {
+        BulletStrip& strip = _bulletStrips[index];
+        toDestroy.insert(toDestroy.end(), strip.destroy.begin(), strip.destroy.end());
+
+        // Summed per strip; subtracting the sums gives the same health as
+        // subtracting bullet by bullet. No player death yet: health stops at 0
+        for (std::size_t p = 0; p < _stripPlayers.size(); ++p) {
+            if (strip.damage[p] == 0) continue;
+            auto& health = healths.get_ref(static_cast<size_t>(_stripPlayers[p].entity)).value();
+            health.current = health.current > strip.damage[p]
+                                 ? static_cast<uint8_t>(health.current - strip.damage[p]) : 0;
+        }
+
+        for (Entity bullet : strip.leaving) {
+            strip.bullets.erase(bullet);
+            _bulletStrips[bulletStrip(positions.get_ref(static_cast<size_t>(bullet)).value().y)]
+                .bullets.insert(bullet);
+        }
+    }
+}
+
+void GameWorld::splitBulletStrips(std::size_t count) {
+    // Rebuilt from scratch: only happens when the pool or the bullet count
+    // crosses a threshold
+    auto& positions = _registry.get_components<Position>();
+    for (auto& strip : _bulletStrips) {
+        strip.bullets.clear();
+    }
+    _bulletStrips.resize(count);
+    for (auto bullet : _enemyBulletEntities) {
+        float y = positions.get_ref(static_cast<size_t>(bullet)).value().y;
+        _bulletStrips[bulletStrip(y)].bullets.insert(bullet);
+    }
+}
+
+void GameWorld::runStrips(const WorkerPool::Job& job) {
+    if (_workers && _bulletStrips.size() > 1) {
+        _workers->run(_bulletStrips.size(), job);
+    } else {
+        for (std::size_t i = 0; i < _bulletStrips.size(); ++i) job(i);
+    }
+}
+
+std::size_t GameWorld::bulletStrip(float y) const {
+    std::size_t count = _bulletStrips.size();
+    float strip = y * static_cast<float>(count) / WORLD_HEIGHT;
+    if (!(strip > 0.0f)) return 0;  // above the screen (or NaN)
+    return std::min(static_cast<std::size_t>(strip), count - 1);
+}
+
+void GameWorld::updateBulletStrip(std::size_t index) {
+    // Runs concurrently with the other strips: only writes the components of
+    // its own bullets and its own results, only reads the player boxes and
+    // the terrain
+    BulletStrip& strip = _bulletStrips[index];
+    auto& positions = _registry.get_components<Position>();
+    auto& velocities = _registry.get_components<Velocity>();
+    auto* damages = _registry.get_components_if<Damage>();
+    const float deltaTime = _tickInterval;
+    const bool terrain = !_terrain.empty();
+
+    strip.destroy.clear();
+    strip.leaving.clear();
+    strip.damage.assign(_stripPlayers.size(), 0);
+    strip.boxes.clear();
+    strip.order.clear();
+
+    // Move, then pack the end-of-tick boxes of the bullets still on screen
+    // and out of the terrain. Enemy bullets move a few pixels per tick
+    // against 48px players and 32px tiles, so the discrete test is enough
+    // (no sweep).
+    float minY = WORLD_HEIGHT + ENEMY_BULLET_MARGIN;
+    float maxY = -ENEMY_BULLET_MARGIN;
+    for (auto bullet : strip.bullets) {
+        size_t idx = static_cast<size_t>(bullet);
+        Position& pos = positions.get_ref(idx).value();
+        const Velocity& vel = velocities.get_ref(idx).value();
+        pos.x += vel.vx * deltaTime;
+        pos.y += vel.vy * deltaTime;
+
+        if (pos.x < -ENEMY_BULLET_MARGIN || pos.x > WORLD_WIDTH + ENEMY_BULLET_MARGIN ||
+            pos.y < -ENEMY_BULLET_MARGIN || pos.y > WORLD_HEIGHT + ENEMY_BULLET_MARGIN) {
+            strip.destroy.push_back(bullet);
+            continue;
+        }
+        AABB box = AABB::fromRect(pos.x, pos.y, ENEMY_BULLET_SIZE, ENEMY_BULLET_SIZE);
+        if (terrain && hitsTerrain(box)) {
+            strip.destroy.push_back(bullet);
+            continue;
+        }
+        minY = std::min(minY, box.minY);
+        maxY = std::max(maxY, box.maxY);
+        strip.boxes.push(box);
+        strip.order.push_back(bullet);
+    }
+
+    std::size_t count = strip.order.size();
+    if (count == 0) {
+        return;
+    }
+
+    strip.hits.resize((count + 31) / 32);
+    strip.spent.assign(count, 0);
+
+    for (std::size_t p = 0; p < _stripPlayers.size(); ++p) {
+        const AABB& playerBox = _stripPlayers[p].box;
+        if (playerBox.maxY < minY || playerBox.minY > maxY) continue;  // Not level with the strip
+        if (overlapBatch(playerBox, strip.boxes, 0, count, strip.hits.data()) == 0) {
+            continue;
+        }
+
+        // A bullet is spent on the first player it touches
+        forEachHit(strip.hits.data(), count, [&](std::size_t i) {
+            if (strip.spent[i]) return;
+            strip.spent[i] = 1;
+
+            Entity bullet = strip.order[i];
+            uint8_t bulletDamage = 10;
+            if (damages) {
+                auto& damage_opt = damages->get_ref(static_cast<size_t>(bullet));
+                if (damage_opt) {
+                    bulletDamage = damage_opt.value().amount;
+                }
+            }
+            strip.damage[p] += bulletDamage;
+            strip.destroy.push_back(bullet);
+        });
+    }
+
+    // Bullets that moved into another strip change strip in the fix-up
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!strip.spent[i] && bulletStrip(strip.boxes.minY[i]) != index) {
+            strip.leaving.push_back(strip.order[i]);
+        }
+    }
+}
+
+void GameWorld::destroyEntity(Entity entity) {
+    // Pooled entities already back in their pool are not alive
+    ProjectilePool* pool = nullptr;
+    if (_playerBullets.owns(entity)) {
+        pool = &_playerBullets;
+    } else if (_enemyBullets.owns(entity)) {
+        pool = &_enemyBullets;
+    }
+    if (pool && !pool->isActive(entity)) {
+        return;
+    }
+
+    // Get network ID before destroying
+    auto* networkIds = _registry.get_components_if<NetworkId>();
+    uint32_t networkId = 0;
+
+    if (networkIds) {
+        auto& netId_opt = networkIds->get_ref(static_cast<size_t>(entity));
+        if (netId_opt) {
+            networkId = netId_opt.value().id;
+        }
+    }
+
+    // Cancel pending timers so they can't fire on a recycled entity index
+    auto* lifetimes = _registry.get_components_if<Lifetime>();
+    if (lifetimes && lifetimes->has(static_cast<size_t>(entity))) {
+        auto& lifetime = lifetimes->get_ref(static_cast<size_t>(entity)).value();
+        _timers.cancel(lifetime.timer);
+        lifetime.timer = 0;
+    }
+    auto* emitters = _registry.get_components_if<Emitter>();
+    if (emitters && emitters->has(static_cast<size_t>(entity))) {
+        auto& emitter = emitters->get_ref(static_cast<size_t>(entity)).value();
+        _timers.cancel(emitter.timer);
+        emitter.timer = 0;
+    }
+    auto* homings = _registry.get_components_if<Homing>();
+    if (homings && homings->has(static_cast<size_t>(entity))) {
+        auto& homing = homings->get_ref(static_cast<size_t>(entity)).value();
+        _timers.cancel(homing.timer);
+        homing.timer = 0;
+    }
+
+    // Remove from tracking containers
+    _enemyEntities.erase(entity);
+    _bulletEntities.erase(entity);
+    if (_enemyBulletEntities.erase(entity)) {
+        for (auto& strip : _bulletStrips) {
+            if (strip.bullets.erase(entity)) break;
+        }
+    }
+    _homingEntities.erase(entity);
+    _curves.remove(entity);
+
+    // Projectiles go back to their pool, everything else is destroyed in ECS
+    if (pool) {
+        pool->release(entity);
+    } else {
+        _registry.kill_entity(entity);
+    }
+
+    emitDestroy(networkId);
+}
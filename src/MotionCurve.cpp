@@ -0,0 +1,148 @@
+#include "../include/MotionCurve.hpp"
+
+void CurveBatch::Lane::push(Entity entity, const MotionCurve& curve) {
+    entities.push_back(entity);
+    start.push_back(curve.startTick);
+    originX.push_back(curve.originX);
+    originY.push_back(curve.originY);
+    for (int k = 0; k < MotionCurve::PARAM_COUNT; ++k) {
+        p[k].push_back(curve.p[k]);
+    }
+}
+
+void CurveBatch::Lane::swapRemove(std::size_t index) {
+    std::size_t last = entities.size() - 1;
+    entities[index] = entities[last];
+    start[index] = start[last];
+    originX[index] = originX[last];
+    originY[index] = originY[last];
+    for (int k = 0; k < MotionCurve::PARAM_COUNT; ++k) {
+        p[k][index] = p[k][last];
+        p[k].pop_back();
+    }
+    entities.pop_back();
+    start.pop_back();
+    originX.pop_back();
+    originY.pop_back();
+}
+
+void CurveBatch::add(Entity entity, const MotionCurve& curve) {
+    std::size_t id = static_cast<std::size_t>(entity);
+    if (contains(entity)) {
+        remove(entity);
+    }
+    if (id >= _slots.size()) {
+        _slots.resize(id + 1);
+    }
+
+    Lane& lane = _lanes[curve.type];
+    _slots[id] = Slot{static_cast<uint32_t>(curve.type), static_cast<uint32_t>(lane.entities.size())};
+    lane.push(entity, curve);
+}
+
+bool CurveBatch::remove(Entity entity) {
+    if (!contains(entity)) {
+        return false;
+    }
+
+    Slot& slot = _slots[static_cast<std::size_t>(entity)];
+    Lane& lane = _lanes[slot.lane];
+    Entity moved = lane.entities.back();
+    lane.swapRemove(slot.index);
+    _slots[static_cast<std::size_t>(moved)].index = slot.index;
+    slot.lane = NPOS;
+    return true;
+}
+
+bool CurveBatch::contains(Entity entity) const noexcept {
+    std::size_t id = static_cast<std::size_t>(entity);
+    return id < _slots.size() && _slots[id].lane != NPOS;
+}
+
+std::size_t CurveBatch::size() const noexcept {
+    std::size_t total = 0;
+    for (const Lane& lane : _lanes) {
+        total += lane.entities.size();
+    }
+    return total;
+}
+
+void CurveBatch::evaluate(Lane& lane, int type) {
+    const std::size_t n = lane.entities.size();
+    const float* t = lane.t.data();
+    float* x = lane.x.data();
+    float* y = lane.y.data();
+    const float* p0 = lane.p[0].data();
+    const float* p1 = lane.p[1].data();
+    const float* p2 = lane.p[2].data();
+    const float* p3 = lane.p[3].data();
+    const float* p4 = lane.p[4].data();
+    const float* p5 = lane.p[5].data();
+    const float* p6 = lane.p[6].data();
+
+    // One loop per type, same per-element code for every entity of the lane
+    switch (type) {
+        case MotionCurve::LINE:
+            for (std::size_t i = 0; i < n; ++i) curves::line(p0[i], p1[i], t[i], x[i], y[i]);
+            break;
+        case MotionCurve::SINE:
+            for (std::size_t i = 0; i < n; ++i) curves::sine(p0[i], p1[i], p2[i], p3[i], t[i], x[i], y[i]);
+            break;
+        case MotionCurve::CIRCLE:
+            for (std::size_t i = 0; i < n; ++i) curves::circle(p0[i], p1[i], p2[i], p3[i], p4[i], t[i], x[i], y[i]);
+            break;
+        case MotionCurve::BEZIER:
+            for (std::size_t i = 0; i < n; ++i) {
+                curves::bezier(p0[i], p1[i], p2[i], p3[i], p4[i], p5[i], p6[i], t[i], x[i], y[i]);
+            }
+            break;
+    }
+
+    const float* ox = lane.originX.data();
+    const float* oy = lane.originY.data();
+    for (std::size_t i = 0; i < n; ++i) {
+        x[i] += ox[i];
+        y[i] += oy[i];
+    }
+}
+
+void CurveBatch::apply(registry& reg, uint64_t tick, float tickInterval) {
+    auto* positions = reg.get_components_if<Position>();
+    auto* velocities = reg.get_components_if<Velocity>();
+    if (!positions) {
+        return;
+    }
+    const float invDt = tickInterval > 0.0f ? 1.0f / tickInterval : 0.0f;
+
+    for (int type = 0; type < MotionCurve::TYPE_COUNT; ++type) {
+        Lane& lane = _lanes[type];
+        const std::size_t n = lane.entities.size();
+        if (n == 0) continue;
+
+        lane.t.resize(n);
+        lane.x.resize(n);
+        lane.y.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            uint64_t elapsed = tick > lane.start[i] ? tick - lane.start[i] : 0;
+            lane.t[i] = static_cast<float>(elapsed) * tickInterval;
+        }
+
+        evaluate(lane, type);
+
+        // Scatter back to the ECS
+        for (std::size_t i = 0; i < n; ++i) {
+            std::size_t idx = static_cast<std::size_t>(lane.entities[i]);
+            auto& pos_opt = positions->get_ref(idx);
+            if (!pos_opt) continue;
+
+            auto& pos = pos_opt.value();
+            if (velocities) {
+                auto& vel_opt = velocities->get_ref(idx);
+                if (vel_opt) {
+                    vel_opt.value() = Velocity{(lane.x[i] - pos.x) * invDt, (lane.y[i] - pos.y) * invDt};
+                }
+            }
+            pos = Position{lane.x[i], lane.y[i]};
+        }
+    }
+}
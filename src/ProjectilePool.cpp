@@ -0,0 +1,52 @@
+#include "../include/ProjectilePool.hpp"
+
+ProjectilePool::ProjectilePool(registry& reg, Builder builder, std::size_t initialSize)
+    : _registry(reg), _builder(std::move(builder)) {
+    _registry.register_component<Pooled>();
+    _free.reserve(initialSize);
+    for (std::size_t i = 0; i < initialSize; ++i) {
+        _free.push_back(create());
+    }
+}
+
+Entity ProjectilePool::create() {
+    Entity entity = _registry.spawn_entity();
+    _builder(_registry, entity);
+    _registry.add_component<Pooled>(entity, Pooled{false});
+    _all.insert(entity);
+    return entity;
+}
+
+Entity ProjectilePool::acquire() {
+    Entity entity = [this] {
+        if (_free.empty()) {
+            return create();
+        }
+        Entity e = _free.back();
+        _free.pop_back();
+        return e;
+    }();
+
+    _registry.get_components<Pooled>().get_ref(static_cast<size_t>(entity)).value().active = true;
+    return entity;
+}
+
+void ProjectilePool::release(Entity entity) {
+    if (!isActive(entity)) {
+        return;
+    }
+    _registry.get_components<Pooled>().get_ref(static_cast<size_t>(entity)).value().active = false;
+    _free.push_back(entity);
+}
+
+bool ProjectilePool::isActive(Entity entity) const {
+    if (!owns(entity)) {
+        return false;
+    }
+    const auto* pooled = _registry.get_components_if<Pooled>();
+    if (!pooled) {
+        return false;
+    }
+    auto state = pooled->get(static_cast<size_t>(entity));
+    return state && state->active;
+}
@@ -0,0 +1,135 @@
+#include "../include/Recording.hpp"
+#include "../include/GameWorld.hpp"
+#include <algorithm>
+#include <cstring>
+
+RecordingWriter::RecordingWriter(const std::string& path, const RecordingHeader& header)
+    : _out(path, std::ios::binary | std::ios::trunc) {
+    _out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+void RecordingWriter::connect(uint8_t playerId, const char* username) {
+    char name[16]{};
+    std::strncpy(name, username, sizeof(name) - 1);
+    _out.put(static_cast<char>(RecordedEvent::CONNECT));
+    _out.put(static_cast<char>(playerId));
+    _out.write(name, sizeof(name));
+    _last[playerId].valid = false;
+}
+
+void RecordingWriter::disconnect(uint8_t playerId) {
+    _out.put(static_cast<char>(RecordedEvent::DISCONNECT));
+    _out.put(static_cast<char>(playerId));
+    _last[playerId].valid = false;
+}
+
+void RecordingWriter::input(uint8_t playerId, int8_t moveX, int8_t moveY, uint8_t buttons,
+                            uint32_t rewindTicks) {
+    uint8_t rewind = static_cast<uint8_t>(std::min<uint32_t>(rewindTicks, 255));
+    LastInput& last = _last[playerId];
+    if (last.valid && last.moveX == moveX && last.moveY == moveY && last.buttons == buttons &&
+        last.rewindTicks == rewind) {
+        _out.put(static_cast<char>(RecordedEvent::REPEAT));
+        _out.put(static_cast<char>(playerId));
+        return;
+    }
+    last = LastInput{true, moveX, moveY, buttons, rewind};
+
+    char record[6] = {static_cast<char>(RecordedEvent::INPUT), static_cast<char>(playerId),
+                      static_cast<char>(moveX), static_cast<char>(moveY),
+                      static_cast<char>(buttons), static_cast<char>(rewind)};
+    _out.write(record, sizeof(record));
+}
+
+void RecordingWriter::tick() {
+    _out.put(static_cast<char>(RecordedEvent::TICK));
+}
+
+void RecordingWriter::checksum(uint64_t value) {
+    _out.put(static_cast<char>(RecordedEvent::CHECKSUM));
+    _out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    _out.flush();
+}
+
+RecordingReader::RecordingReader(const std::string& path)
+    : _in(path, std::ios::binary) {
+    RecordingHeader expected;
+    _ok = _in.read(reinterpret_cast<char*>(&_header), sizeof(_header)) &&
+          std::memcmp(_header.magic, expected.magic, sizeof(expected.magic)) == 0 &&
+          _header.version == expected.version;
+}
+
+bool RecordingReader::next(RecordedEvent& event) {
+    if (!_ok) {
+        return false;
+    }
+    int type = _in.get();
+    if (type == std::char_traits<char>::eof()) {
+        return false;
+    }
+
+    // Fields after the type byte
+    auto read = [&](void* data, std::size_t size) {
+        if (!_in.read(static_cast<char*>(data), static_cast<std::streamsize>(size))) {
+            _truncated = true;
+            return false;
+        }
+        return true;
+    };
+
+    event = RecordedEvent{};
+    event.type = static_cast<RecordedEvent::Type>(type);
+    switch (event.type) {
+        case RecordedEvent::TICK:
+            return true;
+        case RecordedEvent::CONNECT:
+            return read(&event.playerId, 1) && read(event.username, sizeof(event.username));
+        case RecordedEvent::DISCONNECT:
+            return read(&event.playerId, 1);
+        case RecordedEvent::INPUT: {
+            char fields[5];
+            if (!read(fields, sizeof(fields))) return false;
+            event.playerId = static_cast<uint8_t>(fields[0]);
+            event.moveX = static_cast<int8_t>(fields[1]);
+            event.moveY = static_cast<int8_t>(fields[2]);
+            event.buttons = static_cast<uint8_t>(fields[3]);
+            event.rewindTicks = static_cast<uint8_t>(fields[4]);
+            _last[event.playerId] = event;
+            return true;
+        }
+        case RecordedEvent::REPEAT: {
+            uint8_t playerId;
+            if (!read(&playerId, 1)) return false;
+            event = _last[playerId];
+            return true;
+        }
+        case RecordedEvent::CHECKSUM:
+            return read(&event.checksum, sizeof(event.checksum));
+    }
+    _truncated = true;  // Unknown record type
+    return false;
+}
+
+void applyRecordedEvent(GameWorld& world, const RecordedEvent& event) {
+    switch (event.type) {
+        case RecordedEvent::TICK:
+            world.tick();
+            world.clearEvents();
+            break;
+        case RecordedEvent::CONNECT: {
+            char name[sizeof(event.username) + 1]{};
+            std::memcpy(name, event.username, sizeof(event.username));
+            world.spawnPlayer(event.playerId, name);
+            break;
+        }
+        case RecordedEvent::DISCONNECT:
+            world.removePlayer(event.playerId);
+            break;
+        case RecordedEvent::INPUT:
+        case RecordedEvent::REPEAT:
+            world.applyPlayerInput(event.playerId, event.moveX, event.moveY, event.buttons, event.rewindTicks);
+            break;
+        case RecordedEvent::CHECKSUM:
+            break;
+    }
+}
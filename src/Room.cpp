@@ -0,0 +1,478 @@
+#include "../include/Room.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <thread>
+
+Room::Room(uint16_t id, int tickRate, uint32_t levelId, uint64_t seed, const std::string& recordDir,
+           std::size_t snapshotDatagram, WorkerPool* workers, std::function<bool()> wakeSender)
+    : _id(id),
+      _tickRate(tickRate),
+      _levelId(levelId),
+      _snapshotDatagram(std::min(std::max(snapshotDatagram, MIN_DATAGRAM_SIZE), MAX_DATAGRAM_SIZE)),
+      _workers(workers),
+      _wakeSender(std::move(wakeSender)),
+      _seed(seed),
+      _recordDir(recordDir),
+      _netEvents(NET_EVENT_QUEUE_CAPACITY),
+      _outgoing(OUTGOING_QUEUE_CAPACITY) {
+    startMatch();
+}
+
+void Room::startMatch() {
+    _recording.reset();
+    _matchSeed = deriveSeed(_seed, _match++);
+    _world = std::make_unique<GameWorld>(_tickRate, true, _levelId, _matchSeed);
+    _world->setWorkerPool(_workers);
+}
+
+void Room::pushInput(const NetEvent& event) {
+    if (!_netEvents.try_push(event)) {
+        _droppedInputs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Room::tick() {
+    // Apply what the network thread queued since the last tick
+    drainNetEvents();
+    if (_clients.empty()) {
+        return;
+    }
+    applyInputs();
+
+    // Timers, motion, collisions
+    _world->tick();
+    if (_recording) {
+        _recording->tick();
+        // Once per second of simulation, for the replay to check against
+        if (_world->tickCount() % static_cast<uint64_t>(_tickRate) == 0) {
+            _recording->checksum(_world->checksum());
+        }
+    }
+
+    // Spawns and destroys of this tick, queued before its snapshot
+    flushWorldEvents();
+    publishSnapshot();
+}
+
+void Room::drainNetEvents() {
+    NetEvent event;
+    while (_netEvents.try_pop(event)) {
+        switch (event.type) {
+            case NetEvent::INPUT: {
+                auto it = _clients.find(event.playerId);
+                if (it != _clients.end()) {
+                    // Inputs come out of order: keep the newest acknowledgement
+                    uint32_t& ack = it->second.ackTick;
+                    if (static_cast<int32_t>(event.snapshotTick - ack) > 0) {
+                        ack = event.snapshotTick;
+                    }
+                    BufferedInput input{event.sequence, event.timestamp, event.moveX, event.moveY,
+                                        event.buttons, event.snapshotTick};
+                    it->second.inputs.push(input, _world->tickCount());
+                }
+                break;
+            }
+            case NetEvent::CONNECT:
+                connectPlayer(event.playerId, event.username, event.snapshotRate);
+                break;
+            case NetEvent::UDP_READY:
+                sendWorldToPlayer(event.playerId, event.endpoint);
+                break;
+            case NetEvent::DISCONNECT:
+                removePlayer(event.playerId);
+                break;
+        }
+    }
+
+    uint64_t dropped = _droppedInputs.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        std::cerr << "[Room " << _id << "] WARNING: Event queue full, dropped " << dropped << " inputs" << std::endl;
+    }
+}
+
+void Room::applyInputs() {
+    // One input per player per tick, taken from its jitter buffer (the last
+    // one again when nothing arrived in time). The snapshot tick the input
+    // echoes tells how far behind the player's screen is: its shots are
+    // checked against the enemies as they were on that tick. That covers
+    // the ping, the snapshot rate and the time spent in the jitter buffer.
+    uint32_t now = static_cast<uint32_t>(_world->tickCount());
+    BufferedInput input;
+    for (auto& pair : _clients) {
+        if (pair.second.inputs.next(input)) {
+            int32_t behind = static_cast<int32_t>(now - input.snapshotTick);
+            uint32_t rewind = input.snapshotTick != 0 && behind > 0 ? static_cast<uint32_t>(behind) : 0;
+            _world->applyPlayerInput(pair.first, input.moveX, input.moveY, input.buttons, rewind);
+            if (_recording) {
+                _recording->input(pair.first, input.moveX, input.moveY, input.buttons, rewind);
+            }
+        }
+    }
+}
+
+void Room::publishSnapshot() {
+    // Refill a free buffer (vectors keep their capacity from earlier ticks)
+    WorldSnapshot& snapshot = _snapshots.writeBuffer();
+    snapshot.tick = _world->tickCount();
+    snapshot.recipients.clear();
+
+    // The clients whose send slot is this tick, plus those of the previous
+    // snapshot if the sender hasn't taken it yet: publishing overwrites it,
+    // and they would miss their slot
+    const bool unsent = _snapshots.unfetched();
+    for (auto& pair : _clients) {
+        const SimClient& client = pair.second;
+        if (!client.udpReady) {
+            continue;
+        }
+        bool due = snapshot.tick % client.sendInterval == client.sendPhase;
+        if (!due && unsent) {
+            due = std::find(_lastRecipients.begin(), _lastRecipients.end(), client.endpoint) != _lastRecipients.end();
+        }
+        if (due) {
+            snapshot.recipients.push_back({client.endpoint, client.ackTick});
+        }
+    }
+    if (snapshot.recipients.empty()) {
+        return;
+    }
+
+    snapshot.entities.clear();
+    _world->fillSnapshot(snapshot.entities);
+    _lastRecipients.clear();
+    for (const auto& recipient : snapshot.recipients) {
+        _lastRecipients.push_back(recipient.endpoint);
+    }
+    _snapshots.publish();
+}
+
+void Room::send(asio::ip::udp::socket& socket) {
+    // Event packets first: a spawn must reach clients before the snapshot
+    // that contains the new entity
+    OutgoingPacket packet;
+    while (_outgoing.try_pop(packet)) {
+        for (auto& endpoint : packet.targets) {
+            socket.send_to(asio::buffer(packet.data), endpoint);
+        }
+    }
+
+    // Only the latest snapshot matters: it also lists the recipients of the
+    // ones it overwrote
+    if (_snapshots.fetch()) {
+        sendSnapshot(socket, _snapshots.readBuffer());
+    }
+}
+
+void Room::sendSnapshot(asio::ip::udp::socket& socket, const WorldSnapshot& snapshot) {
+    if (snapshot.recipients.empty()) {
+        return;
+    }
+
+    // Keep it as a baseline for the next ones, as the clients will rebuild
+    // it: at the precision of the wire, in the order deltas use
+    const uint32_t tick = static_cast<uint32_t>(snapshot.tick);
+    std::vector<EntityBatchEntry>& current = _sentSnapshots.store(tick);
+    current = snapshot.entities;
+    quantizeSnapshot(current);
+    sortByNetworkId(current);
+
+    static const std::vector<EntityBatchEntry> noBaseline;
+    std::size_t packets = 0;
+    std::size_t bytes = 0;
+    for (std::size_t r = 0; r < snapshot.recipients.size(); ++r) {
+        // One encoding per baseline: skip the clients already sent to
+        const uint32_t ack = snapshot.recipients[r].ackTick;
+        bool encoded = false;
+        for (std::size_t earlier = 0; earlier < r && !encoded; ++earlier) {
+            encoded = snapshot.recipients[earlier].ackTick == ack;
+        }
+        if (encoded) {
+            continue;
+        }
+
+        // A baseline the history no longer has (or none yet): full snapshot
+        const std::vector<EntityBatchEntry>* baseline = ack != tick ? _sentSnapshots.find(ack) : nullptr;
+        _deltaEntries.clear();
+        diffSnapshots(baseline ? *baseline : noBaseline, current, _deltaEntries);
+
+        // Split into as few ENTITY_BATCH_UPDATE fragments as the datagram
+        // size allows (at least one: an empty delta still tells the client
+        // the snapshot exists). Every fragment carries the snapshot tick:
+        // clients reassemble the snapshot from it and echo it in their
+        // inputs, which acknowledges it and lets shots be checked against
+        // what they saw. A fragment's first entry has its full network ID.
+        const std::size_t capacity = (_snapshotDatagram - sizeof(PacketHeader) - sizeof(EntityBatchHeader)) * 8;
+        const std::size_t entries = _deltaEntries.size();
+        _fragmentStarts.assign(1, 0);
+        std::size_t used = 0;
+        uint32_t previousId = 0;
+        for (std::size_t e = 0; e < entries; ++e) {
+            std::size_t bits = deltaEntryBits(_deltaEntries[e], previousId);
+            if (used > 0 && used + bits > capacity) {
+                _fragmentStarts.push_back(e);
+                bits = deltaEntryBits(_deltaEntries[e], 0);
+                used = 0;
+            }
+            used += bits;
+            previousId = _deltaEntries[e].state.networkId;
+        }
+        _fragmentStarts.push_back(entries);
+
+        EntityBatchHeader batch;
+        batch.tick = tick;
+        batch.baselineTick = baseline ? ack : 0;
+        batch.fragmentCount = static_cast<uint16_t>(_fragmentStarts.size() - 1);
+        std::vector<char>& packet = _snapshotPacket;
+        for (std::size_t f = 0; f + 1 < _fragmentStarts.size(); ++f) {
+            const std::size_t first = _fragmentStarts[f];
+            const std::size_t last = _fragmentStarts[f + 1];
+            batch.fragment = static_cast<uint16_t>(f);
+            batch.count = static_cast<uint16_t>(last - first);
+
+            // Entries first, the headers once the size is known
+            packet.resize(sizeof(PacketHeader) + sizeof(EntityBatchHeader));
+            BitWriter writer(packet);
+            previousId = 0;
+            for (std::size_t e = first; e < last; ++e) {
+                writeDeltaEntry(writer, _deltaEntries[e], previousId);
+                previousId = _deltaEntries[e].state.networkId;
+            }
+            writer.finish();
+
+            PacketHeader header;
+            header.type = ENTITY_BATCH_UPDATE;
+            header.payloadSize = static_cast<uint16_t>(packet.size() - sizeof(PacketHeader));
+            header.sessionToken = 0;  // Broadcast to all
+            std::memcpy(packet.data(), &header, sizeof(PacketHeader));
+            std::memcpy(packet.data() + sizeof(PacketHeader), &batch, sizeof(EntityBatchHeader));
+
+            for (std::size_t to = r; to < snapshot.recipients.size(); ++to) {
+                if (snapshot.recipients[to].ackTick == ack) {
+                    socket.send_to(asio::buffer(packet), snapshot.recipients[to].endpoint);
+                    ++packets;
+                    bytes += packet.size();
+                }
+            }
+        }
+    }
+
+    // Log occasionally (about once per second of simulation)
+    ++_broadcastCount;
+    uint64_t second = snapshot.tick / static_cast<uint64_t>(_tickRate);
+    if (second != _lastBroadcastLog) {
+        _lastBroadcastLog = second;
+        std::cout << "[Room " << _id << "] Broadcast update " << _broadcastCount
+                  << " (tick " << snapshot.tick << "): " << snapshot.entities.size()
+                  << " entities, " << packets << " packets of " << bytes << " bytes in all to "
+                  << snapshot.recipients.size() << " clients" << std::endl;
+    }
+}
+
+void Room::sendToAllClients(std::vector<char> packet) {
+    OutgoingPacket out;
+    out.data = std::move(packet);
+    for (auto& pair : _clients) {
+        if (pair.second.udpReady) {
+            out.targets.push_back(pair.second.endpoint);
+        }
+    }
+    if (!out.targets.empty()) {
+        queuePacket(std::move(out));
+    }
+}
+
+void Room::sendToClient(std::vector<char> packet, const asio::ip::udp::endpoint& endpoint) {
+    OutgoingPacket out;
+    out.data = std::move(packet);
+    out.targets.push_back(endpoint);
+    queuePacket(std::move(out));
+}
+
+void Room::queuePacket(OutgoingPacket&& packet) {
+    // Spawn/destroy packets shouldn't be dropped: if the sender fell that far
+    // behind, wake it and wait for room, but never stall the worker for good
+    auto deadline = std::chrono::steady_clock::now() + OUTGOING_QUEUE_WAIT;
+    while (!_outgoing.try_push(std::move(packet))) {
+        if (!_wakeSender() || std::chrono::steady_clock::now() >= deadline) {
+            ++_droppedPackets;
+            std::cerr << "[Room " << _id << "] WARNING: Packet queue full, dropped a packet ("
+                      << _droppedPackets << " so far)" << std::endl;
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+void Room::connectPlayer(uint8_t playerId, const char* username, int snapshotRate) {
+    std::cout << "[Room " << _id << "] Player " << (int)playerId << " connected (TCP)" << std::endl;
+
+    // Snapshot every sendInterval ticks, rounded to the nearest whole tick
+    uint64_t interval = 1;
+    if (snapshotRate > 0 && snapshotRate < _tickRate) {
+        interval = static_cast<uint64_t>((_tickRate + snapshotRate / 2) / snapshotRate);
+    }
+
+    _clients.erase(playerId);
+    uint64_t phase = leastBusyPhase(interval);
+    SimClient& client = _clients[playerId];
+    client.udpReady = false;
+    client.sendInterval = interval;
+    client.sendPhase = phase;
+    client.inputs = InputBuffer(_tickRate);
+    std::cout << "[Room " << _id << "] Player " << (int)playerId << " gets a snapshot every "
+              << interval << " ticks (offset " << phase << ")" << std::endl;
+
+    std::cout << "[Room " << _id << "] Creating entity for player " << (int)playerId
+              << " (will spawn when UDP ready)" << std::endl;
+    if (!_recording && !_recordDir.empty()) {
+        std::string path = _recordDir + "/room" + std::to_string(_id) + "_match" + std::to_string(_match) + ".rec";
+        RecordingHeader header;
+        header.tickRate = static_cast<uint16_t>(_tickRate);
+        header.levelId = _levelId;
+        header.seed = _matchSeed;
+        _recording = std::make_unique<RecordingWriter>(path, header);
+        if (_recording->ok()) {
+            std::cout << "[Room " << _id << "] Recording match to " << path << std::endl;
+        } else {
+            std::cerr << "[Room " << _id << "] WARNING: Cannot write " << path << ", match not recorded" << std::endl;
+            _recording.reset();
+            _recordDir.clear();
+        }
+    }
+    _world->spawnPlayer(playerId, username);
+    if (_recording) {
+        _recording->connect(playerId, username);
+    }
+}
+
+uint64_t Room::leastBusyPhase(uint64_t interval) const {
+    // Two clients share send ticks when their phases agree modulo the gcd of
+    // their intervals, then once every lcm of their intervals. Take the
+    // phase sharing the fewest ticks with the clients already placed.
+    uint64_t best = 0;
+    double bestLoad = 0.0;
+    for (uint64_t phase = 0; phase < interval; ++phase) {
+        double load = 0.0;
+        for (auto& pair : _clients) {
+            uint64_t step = std::gcd(interval, pair.second.sendInterval);
+            if (phase % step == pair.second.sendPhase % step) {
+                load += 1.0 / std::lcm(interval, pair.second.sendInterval);
+            }
+        }
+        if (phase == 0 || load < bestLoad) {
+            best = phase;
+            bestLoad = load;
+        }
+    }
+    return best;
+}
+
+namespace {
+
+template <typename Payload>
+std::vector<char> makePacket(MessageType type, const Payload& payload) {
+    PacketHeader header;
+    header.type = type;
+    header.payloadSize = sizeof(Payload);
+    header.sessionToken = 0;
+
+    std::vector<char> packet(sizeof(PacketHeader) + sizeof(Payload));
+    std::memcpy(packet.data(), &header, sizeof(PacketHeader));
+    std::memcpy(packet.data() + sizeof(PacketHeader), &payload, sizeof(Payload));
+    return packet;
+}
+
+}  // namespace
+
+void Room::sendWorldToPlayer(uint8_t playerId, const asio::ip::udp::endpoint& endpoint) {
+    std::cout << "[Room " << _id << "] Player " << (int)playerId << " UDP ready, sending ENTITY_SPAWN" << std::endl;
+
+    auto clientIt = _clients.find(playerId);
+    if (clientIt == _clients.end()) {
+        std::cerr << "[Room " << _id << "] ERROR: No client found for player " << (int)playerId << std::endl;
+        return;
+    }
+
+    // Events from earlier in this tick go out first, so the world sync below
+    // is never followed by a spawn it already contains
+    flushWorldEvents();
+
+    // Send ENTITY_SPAWN for ALL existing entities (players, enemies, bullets)
+    // to the new player, before it becomes a recipient of the broadcasts
+    std::vector<EntitySpawnPayload> spawns;
+    std::vector<EntityCurvePayload> curves;
+    _world->collectSpawns(spawns, curves);
+    for (const auto& spawnPayload : spawns) {
+        sendToClient(makePacket(ENTITY_SPAWN, spawnPayload), endpoint);
+    }
+    for (const auto& curvePayload : curves) {
+        sendToClient(makePacket(ENTITY_CURVE, curvePayload), endpoint);
+    }
+    LevelScrollPayload scroll;
+    if (_world->levelScroll(scroll)) {
+        sendToClient(makePacket(LEVEL_SCROLL, scroll), endpoint);
+    }
+    std::cout << "[Room " << _id << "] Sent " << spawns.size() << " ENTITY_SPAWN to new player "
+              << (int)playerId << std::endl;
+
+    clientIt->second.endpoint = endpoint;
+    clientIt->second.udpReady = true;
+
+    // Now broadcast THIS new player's entity to ALL clients (including themselves)
+    EntitySpawnPayload spawnPayload;
+    if (_world->playerSpawn(playerId, spawnPayload)) {
+        std::cout << "[Room " << _id << "] Broadcasting new player " << (int)playerId
+                  << " (network ID " << spawnPayload.networkId << ", username: "
+                  << spawnPayload.username << ") to all clients" << std::endl;
+
+        sendToAllClients(makePacket(ENTITY_SPAWN, spawnPayload));
+    }
+}
+
+void Room::removePlayer(uint8_t playerId) {
+    auto clientIt = _clients.find(playerId);
+    if (clientIt != _clients.end()) {
+        const InputBuffer& inputs = clientIt->second.inputs;
+        std::cout << "[Room " << _id << "] Player " << (int)playerId << " inputs: " << inputs.lost()
+                  << " lost, " << inputs.repeated() << " ticks repeated, " << inputs.skipped()
+                  << " skipped (buffer depth " << inputs.target() << ")" << std::endl;
+        _clients.erase(clientIt);
+    }
+    _world->removePlayer(playerId);
+    if (_recording) {
+        _recording->disconnect(playerId);
+    }
+
+    if (_clients.empty()) {
+        // Match over: the next players start a fresh one, from a new seed
+        _world->clearEvents();
+        startMatch();
+        std::cout << "[Room " << _id << "] Empty, world reset" << std::endl;
+    }
+}
+
+void Room::flushWorldEvents() {
+    for (const WorldEvent& event : _world->events()) {
+        switch (event.kind) {
+            case WorldEvent::SPAWN:
+                sendToAllClients(makePacket(ENTITY_SPAWN, event.spawn));
+                break;
+            case WorldEvent::DESTROY:
+                sendToAllClients(makePacket(ENTITY_DESTROY, event.destroy));
+                break;
+            case WorldEvent::CURVE:
+                sendToAllClients(makePacket(ENTITY_CURVE, event.curve));
+                break;
+            case WorldEvent::LEVEL:
+                sendToAllClients(makePacket(LEVEL_SCROLL, event.level));
+                break;
+            case WorldEvent::UPDATE:
+                sendToAllClients(makePacket(ENTITY_UPDATE, event.update));
+                break;
+        }
+    }
+    _world->clearEvents();
+}
@@ -28,12 +28,11 @@ void Session::handleMessage(const std::string& message) {
     std::cout << "[TCP] Client #" << _clientId << " → " << msg.type << std::endl;
 
     if (msg.type == TCPProtocol::CONNECT) {
-        // Vérifier si le serveur est plein (max 4 joueurs)
-        constexpr size_t MAX_PLAYERS = 4;
-        if (_server->getClientCount() > MAX_PLAYERS) {
+        // Une session ne se connecte qu'une fois
+        if (_clientInfo.playerId != 0) {
             TCPProtocol::Message response;
             response.type = TCPProtocol::CONNECT_ERROR;
-            response.params["reason"] = "server_full";
+            response.params["reason"] = "already_connected";
             send(response.serialize());
             return;
         }
@@ -51,11 +50,31 @@ void Session::handleMessage(const std::string& message) {
             return;
         }
 
-        // Générer un token de session et assigner un player ID
-        _clientInfo.playerId = static_cast<uint8_t>(_clientId);
-        _clientInfo.sessionToken = _server->generateSessionToken();
+        // Fréquence des snapshots : celle demandée par le client, plafonnée
+        // à celle du serveur (paramètre absent ou invalide : celle du serveur)
+        int snapshotRate = _server->snapshotRate();
+        if (snapshotRate > 0 && msg.params.count("snapshot_rate")) {
+            try {
+                int requested = std::stoi(msg.params["snapshot_rate"]);
+                if (requested > 0 && requested < snapshotRate) {
+                    snapshotRate = requested;
+                }
+            } catch (const std::exception&) {
+                // Valeur illisible : on garde celle du serveur
+            }
+        }
+
+        // Placer le joueur dans une partie : player ID et token de session
         _clientInfo.username = username;
         _clientInfo.udpInitialized = false;
+        _clientInfo.snapshotRate = snapshotRate;
+        if (!_server->joinRoom(shared_from_this())) {
+            TCPProtocol::Message response;
+            response.type = TCPProtocol::CONNECT_ERROR;
+            response.params["reason"] = "server_full";
+            send(response.serialize());
+            return;
+        }
 
         // Envoyer la réponse CONNECT_OK
         TCPProtocol::Message response;
@@ -68,22 +87,32 @@ void Session::handleMessage(const std::string& message) {
         response.params["token"] = ss.str();
 
         response.params["udp_port"] = std::to_string(_server->getUdpPort());
+        response.params["room"] = std::to_string(_clientInfo.roomId);
+        if (snapshotRate > 0) {
+            response.params["snapshot_rate"] = std::to_string(snapshotRate);
+        }
+
+        // Le client génère le décor à partir de l'ID du niveau
+        if (_server->levelId() != 0) {
+            response.params["level"] = std::to_string(_server->levelId());
+        }
 
         send(response.serialize());
 
         std::cout << "[TCP] Client #" << _clientId << " (" << username << ") authenticated"
+                  << " | Room: " << _clientInfo.roomId
                   << " | Player ID: " << (int)_clientInfo.playerId
                   << " | Token: 0x" << ss.str() << std::endl;
 
         // Notify game logic about new player
-        _server->onPlayerConnected(_clientInfo.playerId);
+        _server->onPlayerConnected(_clientInfo);
 
-        // Notifier les autres joueurs
+        // Notifier les autres joueurs de la partie
         TCPProtocol::Message joinMsg;
         joinMsg.type = TCPProtocol::PLAYER_JOIN;
         joinMsg.params["id"] = std::to_string(_clientInfo.playerId);
         joinMsg.params["username"] = username;
-        _server->broadcastMessage(joinMsg.serialize(), _clientId);
+        _server->broadcastToRoom(_clientInfo.roomId, joinMsg.serialize(), _clientId);
 
     } else if (msg.type == TCPProtocol::DISCONNECT_MSG) {
         // Gérer la déconnexion propre
@@ -95,7 +124,7 @@ void Session::handleMessage(const std::string& message) {
 
         // Notify game logic about player disconnection
         if (_clientInfo.playerId != 0) {
-            _server->onPlayerDisconnected(_clientInfo.playerId);
+            _server->onPlayerDisconnected(_clientInfo);
         }
 
         // Notifier les autres joueurs
@@ -103,7 +132,7 @@ void Session::handleMessage(const std::string& message) {
             TCPProtocol::Message leaveMsg;
             leaveMsg.type = TCPProtocol::PLAYER_LEAVE;
             leaveMsg.params["id"] = std::to_string(_clientInfo.playerId);
-            _server->broadcastMessage(leaveMsg.serialize(), _clientId);
+            _server->broadcastToRoom(_clientInfo.roomId, leaveMsg.serialize(), _clientId);
         }
 
         // Remove this session from the server's session list
@@ -138,7 +167,7 @@ void Session::doRead() {
 
                 // Notify game logic about player disconnection
                 if (_clientInfo.playerId != 0) {
-                    _server->onPlayerDisconnected(_clientInfo.playerId);
+                    _server->onPlayerDisconnected(_clientInfo);
                 }
 
                 // Notifier les autres joueurs du départ
@@ -146,7 +175,7 @@ void Session::doRead() {
                     TCPProtocol::Message leaveMsg;
                     leaveMsg.type = TCPProtocol::PLAYER_LEAVE;
                     leaveMsg.params["id"] = std::to_string(_clientInfo.playerId);
-                    _server->broadcastMessage(leaveMsg.serialize(), _clientId);
+                    _server->broadcastToRoom(_clientInfo.roomId, leaveMsg.serialize(), _clientId);
                 }
 
                 // Remove this session from the server's session list
@@ -257,13 +286,8 @@ void Server::handleUDPPacket(const char* data, size_t length,
     }
 
     // Trouver le client avec ce token
-    std::shared_ptr<Session> clientSession = nullptr;
-    for (auto& session : _sessions) {
-        if (session->getClientInfo().sessionToken == header.sessionToken) {
-            clientSession = session;
-            break;
-        }
-    }
+    auto tokenIt = _sessionsByToken.find(header.sessionToken);
+    std::shared_ptr<Session> clientSession = tokenIt != _sessionsByToken.end() ? tokenIt->second : nullptr;
 
     if (!clientSession) {
         std::cerr << "[UDP] Packet with invalid token: 0x" << std::hex
@@ -282,7 +306,7 @@ void Server::handleUDPPacket(const char* data, size_t length,
                   << senderEndpoint.port() << std::endl;
         
         // Notify game logic that UDP is ready
-        onPlayerUdpReady(clientSession->getClientInfo().playerId);
+        onPlayerUdpReady(clientSession->getClientInfo());
     }
 
     // Traiter le paquet selon son type
@@ -292,7 +316,7 @@ void Server::handleUDPPacket(const char* data, size_t length,
                 PlayerInputPayload payload;
                 std::memcpy(&payload, data + sizeof(PacketHeader), sizeof(PlayerInputPayload));
 
-                // SECURITY: Use the playerId from the authenticated session, NOT from the payload
+                // SECURITY: Use the room and playerId from the authenticated session, NOT from the payload
                 // This prevents clients from controlling other players by sending fake playerIds
                 uint8_t authenticatedPlayerId = clientSession->getClientInfo().playerId;
 
@@ -312,14 +336,15 @@ void Server::handleUDPPacket(const char* data, size_t length,
 
                 // N'afficher que s'il y a un input réel (pas de mouvement vide)
                 if (direction != "-" || buttons != "-") {
-                    std::cout << "[UDP] Player " << (int)authenticatedPlayerId
+                    std::cout << "[UDP] Room " << clientSession->getClientInfo().roomId
+                              << " Player " << (int)authenticatedPlayerId
                               << " → Direction: [" << direction << "]"
                               << " | Buttons: [" << buttons << "]"
                               << std::endl;
                 }
 
                 // Apply input to game logic using authenticated player ID
-                handlePlayerInput(authenticatedPlayerId, payload.moveX, payload.moveY, payload.buttons);
+                handlePlayerInput(clientSession->getClientInfo(), payload);
             }
             break;
         }
@@ -351,7 +376,72 @@ void Server::broadcastMessage(const std::string& message, int excludeClientId) {
     }
 }
 
+void Server::broadcastToRoom(uint16_t roomId, const std::string& message, int excludeClientId) {
+    for (auto& session : _sessions) {
+        const ClientInfo& info = session->getClientInfo();
+        if (info.playerId != 0 && info.roomId == roomId && session->getId() != excludeClientId) {
+            session->send(message);
+        }
+    }
+}
+
+bool Server::joinRoom(const std::shared_ptr<Session>& session) {
+    constexpr uint8_t FULL = static_cast<uint8_t>((1u << PLAYERS_PER_ROOM) - 1);
+
+    // Compléter d'abord une partie en cours, sinon reprendre une partie vide,
+    // sinon en créer une nouvelle
+    std::size_t room = _roomSlots.size();
+    for (std::size_t i = 0; i < _roomSlots.size(); ++i) {
+        if (_roomSlots[i] == FULL) continue;
+        if (_roomSlots[i] != 0) {
+            room = i;
+            break;
+        }
+        if (room == _roomSlots.size()) room = i;
+    }
+    if (room == _roomSlots.size()) {
+        if (room >= maxRooms()) {
+            return false;
+        }
+        _roomSlots.push_back(0);
+    }
+
+    // Plus petit player ID libre de la partie
+    uint8_t slot = 0;
+    while (_roomSlots[room] & (1u << slot)) ++slot;
+    _roomSlots[room] |= static_cast<uint8_t>(1u << slot);
+
+    // Token unique : il sert à router les paquets UDP
+    uint32_t token;
+    do {
+        token = generateSessionToken();
+    } while (_sessionsByToken.count(token));
+
+    ClientInfo& info = session->getClientInfo();
+    info.roomId = static_cast<uint16_t>(room);
+    info.playerId = static_cast<uint8_t>(slot + 1);
+    info.sessionToken = token;
+    _sessionsByToken[token] = session;
+    return true;
+}
+
+void Server::leaveRoom(ClientInfo& info) {
+    if (info.playerId == 0) {
+        return;
+    }
+    _roomSlots[info.roomId] &= static_cast<uint8_t>(~(1u << (info.playerId - 1)));
+    _sessionsByToken.erase(info.sessionToken);
+    info.playerId = 0;
+}
+
 void Server::removeSession(int clientId) {
+    // Libérer la place dans la partie avant de retirer la session
+    for (auto& session : _sessions) {
+        if (session->getId() == clientId) {
+            leaveRoom(session->getClientInfo());
+        }
+    }
+
     auto it = std::remove_if(_sessions.begin(), _sessions.end(),
         [clientId](const std::shared_ptr<Session>& session) {
             return session->getId() == clientId;
@@ -0,0 +1,70 @@
+#include "../include/SpatialHash.hpp"
+#include <algorithm>
+#include <cmath>
+
+SpatialHash::SpatialHash(float originX, float originY, float width, float height, float cellSize)
+    : _originX(originX),
+      _originY(originY),
+      _cellSize(cellSize),
+      _invCellSize(1.0f / cellSize),
+      _columns(std::max(1, static_cast<int>(std::ceil(width / cellSize)))),
+      _rows(std::max(1, static_cast<int>(std::ceil(height / cellSize)))) {
+    _cellStart.assign(static_cast<std::size_t>(_columns) * _rows + 1, 0);
+}
+
+void SpatialHash::clear() {
+    _entries.clear();
+    _cellEntries.clear();
+    _cellBoxes.clear();
+    std::fill(_cellStart.begin(), _cellStart.end(), 0);
+}
+
+void SpatialHash::insert(uint32_t id, const AABB& box) {
+    _entries.push_back(Entry{id, cellRange(box), box});
+}
+
+void SpatialHash::build() {
+    std::fill(_cellStart.begin(), _cellStart.end(), 0);
+
+    // Count entries per cell (shifted by one for the prefix sum)
+    for (const Entry& e : _entries) {
+        for (int cy = e.range.y0; cy <= e.range.y1; ++cy) {
+            for (int cx = e.range.x0; cx <= e.range.x1; ++cx) {
+                ++_cellStart[static_cast<std::size_t>(cy) * _columns + cx + 1];
+            }
+        }
+    }
+
+    for (std::size_t c = 1; c < _cellStart.size(); ++c) {
+        _cellStart[c] += _cellStart[c - 1];
+    }
+
+    // Scatter entry indices into their cells
+    _cellEntries.resize(_cellStart.back());
+    _cellBoxes.resize(_cellStart.back());
+    _cursor.assign(_cellStart.begin(), _cellStart.end() - 1);
+    for (uint32_t i = 0; i < _entries.size(); ++i) {
+        const Entry& e = _entries[i];
+        for (int cy = e.range.y0; cy <= e.range.y1; ++cy) {
+            for (int cx = e.range.x0; cx <= e.range.x1; ++cx) {
+                uint32_t slot = _cursor[static_cast<std::size_t>(cy) * _columns + cx]++;
+                _cellEntries[slot] = i;
+                _cellBoxes.set(slot, e.box);
+            }
+        }
+    }
+}
+
+SpatialHash::CellRange SpatialHash::cellRange(const AABB& box) const {
+    return CellRange{cellX(box.minX), cellY(box.minY), cellX(box.maxX), cellY(box.maxY)};
+}
+
+int SpatialHash::cellX(float x) const {
+    int c = static_cast<int>(std::floor((x - _originX) * _invCellSize));
+    return std::clamp(c, 0, _columns - 1);
+}
+
+int SpatialHash::cellY(float y) const {
+    int c = static_cast<int>(std::floor((y - _originY) * _invCellSize));
+    return std::clamp(c, 0, _rows - 1);
+}
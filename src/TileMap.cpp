@@ -0,0 +1,184 @@
+#include "../include/TileMap.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Small integer generator: level generation must not depend on the
+// standard library's distributions, which differ between implementations
+struct LevelRng {
+    uint32_t state;
+
+    explicit LevelRng(uint32_t seed) : state(seed * 0x9E3779B9u + 0x7F4A7C15u) {
+        if (state == 0) state = 1;
+    }
+
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    int range(int lo, int hi) {  // inclusive
+        return lo + static_cast<int>(next() % static_cast<uint32_t>(hi - lo + 1));
+    }
+};
+
+}  // namespace
+
+TileMap::TileMap(int columns, int rows, float tileSize)
+    : _columns(std::max(1, columns)),
+      _rows(std::max(1, rows)),
+      _wordsPerRow((_columns + 63) / 64),
+      _tileSize(tileSize),
+      _invTileSize(1.0f / tileSize) {
+    _bits.assign(static_cast<std::size_t>(_wordsPerRow) * _rows, 0);
+}
+
+TileMap TileMap::generate(uint32_t levelId, int columns, int rows, float tileSize) {
+    TileMap map(columns, rows, tileSize);
+    if (levelId == 0) {
+        return map;
+    }
+
+    // Cave: ceiling and floor walls whose height drifts every few columns,
+    // with pillars growing from them. The middle band (where players spawn)
+    // always stays open.
+    LevelRng rng(levelId);
+    const int band = std::max(1, map._rows / 4);
+    const int maxWall = std::max(0, (map._rows - band) / 2 - 1);
+    int ceiling = 1;
+    int floor = 1;
+    for (int c = 0; c < map._columns; ++c) {
+        if (c % 4 == 0) {
+            ceiling = std::clamp(ceiling + rng.range(-1, 1), 0, maxWall / 2);
+            floor = std::clamp(floor + rng.range(-1, 1), 0, maxWall / 2);
+        }
+        int top = ceiling;
+        int bottom = floor;
+        if (c % 16 >= 12 && c % 16 < 14) {
+            // Two-column pillar, up to the edge of the band
+            if ((c / 16) % 2 == 0) top = maxWall;
+            else bottom = maxWall;
+        }
+        for (int r = 0; r < top; ++r) map.set(c, r, true);
+        for (int r = 0; r < bottom; ++r) map.set(c, map._rows - 1 - r, true);
+    }
+    return map;
+}
+
+void TileMap::set(int column, int row, bool solid) {
+    if (column < 0 || column >= _columns || row < 0 || row >= _rows) {
+        return;
+    }
+    uint64_t& word = _bits[static_cast<std::size_t>(row) * _wordsPerRow + (column >> 6)];
+    const uint64_t bit = uint64_t{1} << (column & 63);
+    if (solid && !(word & bit)) {
+        word |= bit;
+        ++_solidCount;
+    } else if (!solid && (word & bit)) {
+        word &= ~bit;
+        --_solidCount;
+    }
+}
+
+bool TileMap::solid(int column, int row) const {
+    if (row < 0 || row >= _rows || _bits.empty()) {
+        return false;
+    }
+    column = wrapColumn(column);
+    return (_bits[static_cast<std::size_t>(row) * _wordsPerRow + (column >> 6)] >> (column & 63)) & 1u;
+}
+
+bool TileMap::solidAt(float x, float y) const {
+    return solid(static_cast<int>(std::floor(x * _invTileSize)), static_cast<int>(std::floor(y * _invTileSize)));
+}
+
+bool TileMap::overlaps(const AABB& box) const {
+    if (_solidCount == 0) {
+        return false;
+    }
+
+    // Tiles touched by the box (strict: a box ending on a tile edge does not
+    // reach the next tile, as with aabbOverlap)
+    const int r0 = std::max(0, static_cast<int>(std::floor(box.minY * _invTileSize)));
+    const int r1 = std::min(_rows - 1, static_cast<int>(std::ceil(box.maxY * _invTileSize)) - 1);
+    if (r0 > r1) {
+        return false;
+    }
+    const int c0 = static_cast<int>(std::floor(box.minX * _invTileSize));
+    const int c1 = static_cast<int>(std::ceil(box.maxX * _invTileSize)) - 1;
+    if (c0 > c1) {
+        return false;
+    }
+
+    // Split the column range where it wraps around the end of the level
+    const int span = c1 - c0 + 1;
+    const int first = span >= _columns ? 0 : wrapColumn(c0);
+    const int last = span >= _columns ? _columns - 1 : first + span - 1;
+    for (int r = r0; r <= r1; ++r) {
+        if (last < _columns) {
+            if (anySolid(r, first, last)) return true;
+        } else {
+            if (anySolid(r, first, _columns - 1) || anySolid(r, 0, last - _columns)) return true;
+        }
+    }
+    return false;
+}
+
+bool TileMap::sweep(const AABB& box, float dx, float dy, float& toi) const {
+    // Cheap reject on the box covering the whole motion
+    const AABB swept{std::min(box.minX, box.minX + dx), std::min(box.minY, box.minY + dy),
+                     std::max(box.maxX, box.maxX + dx), std::max(box.maxY, box.maxY + dy)};
+    if (!overlaps(swept)) {
+        return false;
+    }
+
+    // Exact swept test against every solid tile under the swept box, rows
+    // without any solid tile in range skipped with one word test
+    const int r0 = std::max(0, static_cast<int>(std::floor(swept.minY * _invTileSize)));
+    const int r1 = std::min(_rows - 1, static_cast<int>(std::ceil(swept.maxY * _invTileSize)) - 1);
+    const int c0 = static_cast<int>(std::floor(swept.minX * _invTileSize));
+    const int c1 = static_cast<int>(std::ceil(swept.maxX * _invTileSize)) - 1;
+    bool hit = false;
+    float first = 2.0f;
+    for (int r = r0; r <= r1; ++r) {
+        const float tileY = r * _tileSize;
+        if (!overlaps(AABB{swept.minX, tileY, swept.maxX, tileY + _tileSize})) continue;
+        for (int c = c0; c <= c1; ++c) {
+            if (!solid(c, r)) continue;
+            const float tileX = c * _tileSize;
+            float t;
+            if (sweptAABB(box, dx, dy, AABB{tileX, tileY, tileX + _tileSize, tileY + _tileSize}, t) && t < first) {
+                first = t;
+                hit = true;
+            }
+        }
+    }
+    if (hit) {
+        toi = first;
+    }
+    return hit;
+}
+
+bool TileMap::anySolid(int row, int c0, int c1) const {
+    const uint64_t* words = &_bits[static_cast<std::size_t>(row) * _wordsPerRow];
+    const int w0 = c0 >> 6;
+    const int w1 = c1 >> 6;
+    const uint64_t firstMask = ~uint64_t{0} << (c0 & 63);
+    const uint64_t lastMask = ~uint64_t{0} >> (63 - (c1 & 63));
+    if (w0 == w1) {
+        return (words[w0] & firstMask & lastMask) != 0;
+    }
+    if (words[w0] & firstMask) return true;
+    for (int w = w0 + 1; w < w1; ++w) {
+        if (words[w]) return true;
+    }
+    return (words[w1] & lastMask) != 0;
+}
+
+int TileMap::wrapColumn(int column) const {
+    column %= _columns;
+    return column < 0 ? column + _columns : column;
+}
@@ -0,0 +1,96 @@
+#include "../include/WorkerPool.hpp"
+
+namespace {
+
+// Pool whose batch the current thread is running a job of
+thread_local const WorkerPool* t_currentPool = nullptr;
+
+}  // namespace
+
+WorkerPool::WorkerPool(std::size_t threads) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    // The caller of run() is one of the threads
+    for (std::size_t i = 1; i < threads; ++i) {
+        _threads.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _wake.notify_all();
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::run(std::size_t count, const Job& job) {
+    if (count == 0) {
+        return;
+    }
+    if (_threads.empty() || count == 1 || inJob()) {
+        for (std::size_t i = 0; i < count; ++i) job(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _job = &job;
+        _count = count;
+        _next.store(0, std::memory_order_relaxed);
+        _busy = _threads.size();
+        ++_generation;
+    }
+    _wake.notify_all();
+
+    work(job);
+
+    // Every worker takes part in every batch, so none can still be reading
+    // the job once they have all checked out
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this] { return _busy == 0; });
+    _job = nullptr;
+}
+
+bool WorkerPool::inJob() const noexcept {
+    return t_currentPool == this;
+}
+
+void WorkerPool::work(const Job& job) {
+    t_currentPool = this;
+    while (true) {
+        std::size_t i = _next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= _count) {
+            break;
+        }
+        job(i);
+    }
+    t_currentPool = nullptr;
+}
+
+void WorkerPool::workerLoop() {
+    uint64_t seen = 0;
+    while (true) {
+        const Job* job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [&] { return _stopping || _generation != seen; });
+            if (_stopping) {
+                return;
+            }
+            seen = _generation;
+            job = _job;
+        }
+
+        work(*job);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_busy == 0) {
+            _done.notify_one();
+        }
+    }
+}
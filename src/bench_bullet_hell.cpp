@@ -0,0 +1,208 @@
+// Bullet-hell scenario benchmark
+//
+// Runs the server's GameWorld headless (no sockets) with a grid of stationary
+// enemies firing radial, spiral and aimed patterns at four idle players,
+// until the screen holds the requested number of live enemy projectiles.
+// Then times full ticks at 60 Hz: timers and volleys, motion, lifetimes,
+// bullet vs enemy and enemy bullet vs player collisions, plus the snapshot
+// fill the game thread does after every tick. The budget is one 60 Hz
+// frame (16.6 ms).
+//
+// The scene is run twice: with the projectiles stored in spawn order, then
+// with the periodic Morton (Z-order) reorder of their component storage
+// turned on. Both runs must end on the same world checksum. With threads > 1
+// the enemy bullet strips of both runs are simulated on a worker pool of
+// that size.
+//
+// Usage: ./bench_bullet_hell [live_bullets] [ticks] [threads]
+
+#include "../include/GameWorld.hpp"
+#include "../include/WorkerPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int TICK_RATE = 60;
+constexpr double BUDGET_US = 1000000.0 / TICK_RATE;
+
+// Every emitter fires 16 bullets 4 times per second; enemy bullets live 6 s
+// unless they leave the screen or hit a player first
+constexpr int VOLLEY_SIZE = 16;
+constexpr float VOLLEY_INTERVAL = 0.25f;
+constexpr float BULLET_SPEED = 60.0f;
+constexpr float BULLET_LIFETIME = 6.0f;
+constexpr int WARMUP_LIMIT_TICKS = 30 * TICK_RATE;
+// Second run: projectile storage reordered by Morton code twice per second
+constexpr float SORT_PERIOD = 0.5f;
+
+double percentile(std::vector<double> samples, double p) {
+    std::sort(samples.begin(), samples.end());
+    std::size_t i = static_cast<std::size_t>(p * (samples.size() - 1));
+    return samples[i];
+}
+
+void spawnEmitters(GameWorld& world, int count) {
+    int columns = static_cast<int>(std::ceil(std::sqrt(count * 2.0)));
+    int rows = (count + columns - 1) / columns;
+    for (int i = 0; i < count; ++i) {
+        float x = 150.0f + 500.0f * (i % columns) / std::max(1, columns - 1);
+        float y = 150.0f + 300.0f * (i / columns) / std::max(1, rows - 1);
+
+        Emitter emitter{Emitter::RADIAL, VOLLEY_SIZE, BULLET_SPEED, VOLLEY_INTERVAL};
+        switch (i % 3) {
+            case 0:
+                emitter.angle = 0.1f * i;
+                break;
+            case 1:
+                emitter.pattern = Emitter::SPIRAL;
+                emitter.spin = 0.3f;
+                break;
+            default:
+                emitter.pattern = Emitter::AIMED;
+                emitter.spread = 1.2f;
+                break;
+        }
+        world.spawnEnemy(MotionCurve{MotionCurve::LINE, x, y}, emitter);  // Stationary
+    }
+}
+
+struct RunResult {
+    int emitters{0};
+    int warmup{0};
+    std::size_t liveStart{0};
+    std::size_t minLive{0};
+    std::size_t maxLive{0};
+    std::size_t snapshotEntries{0};
+    double eventsPerTick{0.0};
+    std::vector<double> tickUs;
+    double snapshotMean{0.0};
+    TickProfile profile;
+    uint64_t checksum{0};
+};
+
+// Same deterministic scene for every run (no random spawns, fixed emitters)
+bool runScenario(std::size_t target, int ticks, float sortPeriod, WorkerPool* pool, RunResult& result) {
+    GameWorld world(TICK_RATE, false);
+    world.setSpatialSortPeriod(sortPeriod);
+    world.setWorkerPool(pool);
+    for (uint8_t player = 1; player <= 4; ++player) {
+        world.spawnPlayer(player, "Bench" + std::to_string(player));
+    }
+
+    // Emitters x bullets per second x lifetime would be the steady state if
+    // every bullet expired; about a third leave the screen or hit a player
+    // before that, so aim for twice the target
+    double perEmitter = VOLLEY_SIZE / VOLLEY_INTERVAL * BULLET_LIFETIME;
+    result.emitters = static_cast<int>(std::ceil(target * 2.0 / perEmitter));
+    spawnEmitters(world, result.emitters);
+
+    std::vector<EntityBatchEntry> snapshot;
+    while (world.enemyBulletCount() < target && result.warmup < WARMUP_LIMIT_TICKS) {
+        world.tick();
+        world.clearEvents();
+        ++result.warmup;
+    }
+    if (world.enemyBulletCount() < target) {
+        std::cerr << "Only reached " << world.enemyBulletCount() << " live bullets after "
+                  << result.warmup << " ticks" << std::endl;
+        return false;
+    }
+
+    std::vector<double> snapshotUs;
+    result.tickUs.reserve(ticks);
+    snapshotUs.reserve(ticks);
+    std::size_t events = 0;
+    result.liveStart = world.enemyBulletCount();
+    result.minLive = result.liveStart;
+    result.maxLive = result.liveStart;
+
+    for (int i = 0; i < ticks; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        world.tick(result.profile);
+        auto simulated = std::chrono::steady_clock::now();
+        snapshot.clear();
+        world.fillSnapshot(snapshot);
+        auto end = std::chrono::steady_clock::now();
+
+        events += world.events().size();
+        world.clearEvents();
+        result.tickUs.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+        snapshotUs.push_back(std::chrono::duration<double, std::micro>(end - simulated).count());
+        result.minLive = std::min(result.minLive, world.enemyBulletCount());
+        result.maxLive = std::max(result.maxLive, world.enemyBulletCount());
+    }
+
+    for (double us : snapshotUs) result.snapshotMean += us;
+    result.snapshotMean /= snapshotUs.size();
+    result.snapshotEntries = snapshot.size();
+    result.eventsPerTick = events / static_cast<double>(ticks);
+    result.checksum = world.checksum();
+    return true;
+}
+
+double report(const char* label, const RunResult& result) {
+    double mean = 0.0;
+    for (double us : result.tickUs) mean += us;
+    mean /= result.tickUs.size();
+    double worst = *std::max_element(result.tickUs.begin(), result.tickUs.end());
+
+    std::cout << label << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  live bullets:  " << result.minLive << " - " << result.maxLive
+              << ", snapshot entries: " << result.snapshotEntries << std::endl;
+    std::cout << "  spawn/destroy events per tick: " << result.eventsPerTick << std::endl;
+    std::cout << "  tick (us):     mean " << mean << ", p50 " << percentile(result.tickUs, 0.5)
+              << ", p99 " << percentile(result.tickUs, 0.99) << ", max " << worst << std::endl;
+    std::cout << "  of which snapshot fill: mean " << result.snapshotMean << " us, spatial sort: mean "
+              << result.profile.us[TickProfile::SPATIAL_SORT] / result.tickUs.size() << " us" << std::endl;
+    std::cout << "  budget " << BUDGET_US << " us: " << (worst <= BUDGET_US ? "OK" : "EXCEEDED")
+              << " (worst tick uses " << (100.0 * worst / BUDGET_US) << "%)" << std::endl;
+    return worst;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t target = 10000;
+    int ticks = 10 * TICK_RATE;
+    int threads = 1;
+    try {
+        if (argc > 1) target = static_cast<std::size_t>(std::max(1, std::stoi(argv[1])));
+        if (argc > 2) ticks = std::max(1, std::stoi(argv[2]));
+        if (argc > 3) threads = std::max(1, std::stoi(argv[3]));
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [live_bullets] [ticks] [threads]" << std::endl;
+        return 1;
+    }
+
+    WorkerPool pool(static_cast<std::size_t>(threads));
+    WorkerPool* strips = threads > 1 ? &pool : nullptr;
+    RunResult unsorted;
+    RunResult sorted;
+    if (!runScenario(target, ticks, 0.0f, strips, unsorted) ||
+        !runScenario(target, ticks, SORT_PERIOD, strips, sorted)) {
+        return 1;
+    }
+
+    std::cout << "Bullet hell: " << unsorted.emitters << " emitters, " << unsorted.liveStart
+              << " live enemy bullets after " << unsorted.warmup << " warm-up ticks, timing "
+              << ticks << " ticks at " << TICK_RATE << " Hz ("
+              << collisionKernelName() << " kernel, " << threads << " thread"
+              << (threads > 1 ? "s" : "") << ")" << std::endl;
+    double worst = report("Spawn order:", unsorted);
+    double sortedWorst = report("Morton order (storage reordered every 0.5 s):", sorted);
+
+    // The reorder only moves projectiles between entity IDs
+    if (sorted.checksum != unsorted.checksum) {
+        std::cerr << "Checksum mismatch: " << std::hex << unsorted.checksum << " vs " << sorted.checksum
+                  << std::endl;
+        return 3;
+    }
+    return std::max(worst, sortedWorst) <= BUDGET_US ? 0 : 2;
+}
@@ -0,0 +1,311 @@
+// Collision pass micro-benchmark
+//
+// 1. Compares the brute-force bullet x enemy loop previously used by
+//    GameServer::checkCollisions with the uniform-grid broadphase, for
+//    growing bullet and enemy counts spread over the 800x600 play area.
+// 2. Compares the narrow-phase loops for one collider against N boxes: the
+//    former per-pair loop reading Position/Drawable through registry
+//    lookups, a scalar loop over packed boxes, and the batch kernel.
+// 3. Compares a compound collider with N hitboxes queried through its BVH
+//    against testing every hitbox, and against a single simple enemy.
+//
+// Usage: ./bench_collision [iterations]
+
+#include "../include/Collision.hpp"
+#include "../include/SpatialHash.hpp"
+#include "../include/ColliderShape.hpp"
+#include "../include/Registry.hpp"
+#include "../include/Components.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Scene {
+    std::vector<AABB> bullets;
+    std::vector<AABB> enemies;
+};
+
+Scene makeScene(std::size_t bulletCount, std::size_t enemyCount, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> xDist(0.0f, 800.0f);
+    std::uniform_real_distribution<float> yDist(0.0f, 600.0f);
+
+    Scene scene;
+    scene.bullets.reserve(bulletCount);
+    scene.enemies.reserve(enemyCount);
+    for (std::size_t i = 0; i < bulletCount; ++i) {
+        scene.bullets.push_back(AABB::fromRect(xDist(gen), yDist(gen), 8.0f, 2.0f));
+    }
+    for (std::size_t i = 0; i < enemyCount; ++i) {
+        scene.enemies.push_back(AABB::fromRect(xDist(gen), yDist(gen), 40.0f, 40.0f));
+    }
+    return scene;
+}
+
+// Returns the number of bullets that hit something (keeps the work observable)
+std::size_t bruteForcePass(const Scene& scene) {
+    std::size_t hits = 0;
+    for (const AABB& bullet : scene.bullets) {
+        for (const AABB& enemy : scene.enemies) {
+            if (aabbOverlap(bullet, enemy)) {
+                ++hits;
+                break;
+            }
+        }
+    }
+    return hits;
+}
+
+std::size_t gridPass(const Scene& scene, SpatialHash& grid) {
+    grid.clear();
+    for (uint32_t i = 0; i < scene.enemies.size(); ++i) {
+        grid.insert(i, scene.enemies[i]);
+    }
+    grid.build();
+
+    std::size_t hits = 0;
+    for (const AABB& bullet : scene.bullets) {
+        uint32_t hitIndex = UINT32_MAX;
+        grid.query(bullet, [&](uint32_t candidate) {
+            if (candidate < hitIndex && aabbOverlap(bullet, scene.enemies[candidate])) {
+                hitIndex = candidate;
+            }
+        });
+        if (hitIndex != UINT32_MAX) ++hits;
+    }
+    return hits;
+}
+
+template <typename Pass>
+double timePass(int iterations, Pass&& pass, std::size_t& hits) {
+    using clock = std::chrono::steady_clock;
+    // Accumulate every result so no iteration can be optimized away
+    std::size_t total = 0;
+    auto start = clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        total += pass();
+    }
+    hits = total / iterations;
+    auto elapsed = std::chrono::duration<double, std::micro>(clock::now() - start);
+    return elapsed.count() / iterations;
+}
+
+// Former narrow phase: one optional lookup per component and per pair
+std::size_t registryLoop(registry& reg, const std::vector<Entity>& enemies, const AABB& probe) {
+    auto* positions = reg.get_components_if<Position>();
+    auto* drawables = reg.get_components_if<Drawable>();
+    std::size_t hits = 0;
+    for (auto enemy : enemies) {
+        size_t idx = static_cast<size_t>(enemy);
+        auto& pos_opt = positions->get_ref(idx);
+        auto& draw_opt = drawables->get_ref(idx);
+        if (!pos_opt || !draw_opt) continue;
+        auto& pos = pos_opt.value();
+        auto& draw = draw_opt.value();
+        if (probe.minX < pos.x + draw.width && probe.maxX > pos.x &&
+            probe.minY < pos.y + draw.height && probe.maxY > pos.y) {
+            ++hits;
+        }
+    }
+    return hits;
+}
+
+std::size_t scalarLoop(const std::vector<AABB>& boxes, const AABB& probe) {
+    std::size_t hits = 0;
+    for (const AABB& box : boxes) {
+        if (aabbOverlap(probe, box)) ++hits;
+    }
+    return hits;
+}
+
+int runKernelBench(int iterations) {
+    std::cout << std::endl;
+    std::cout << "Narrow phase, one probe vs N boxes, kernel: " << collisionKernelName() << std::endl;
+    std::cout << std::setw(8) << "boxes" << std::setw(16) << "registry (ns)"
+              << std::setw(14) << "scalar (ns)" << std::setw(14) << "kernel (ns)"
+              << std::setw(10) << "speedup" << std::endl;
+
+    const std::size_t counts[] = {8, 32, 128, 512, 2048, 8192};
+    const int repeats = iterations * 20;
+
+    for (std::size_t count : counts) {
+        std::mt19937 gen(42u);
+        std::uniform_real_distribution<float> xDist(0.0f, 800.0f);
+        std::uniform_real_distribution<float> yDist(0.0f, 600.0f);
+
+        registry reg;
+        std::vector<Entity> enemies;
+        std::vector<AABB> boxes;
+        AABBBatch batch;
+        for (std::size_t i = 0; i < count; ++i) {
+            float x = xDist(gen);
+            float y = yDist(gen);
+            Entity e = reg.spawn_entity();
+            // Interleave other entities like bullets do in the real registry
+            reg.spawn_entity();
+            reg.add_component<Position>(e, Position{x, y});
+            reg.add_component<Drawable>(e, Drawable{40.0f, 40.0f});
+            enemies.push_back(e);
+            boxes.push_back(AABB::fromRect(x, y, 40.0f, 40.0f));
+            batch.push(boxes.back());
+        }
+        std::vector<uint32_t> mask((count + 31) / 32);
+        AABB probe = AABB::fromRect(380.0f, 280.0f, 48.0f, 48.0f);
+
+        std::size_t regHits = 0, scalarHits = 0, kernelHits = 0;
+        double regNs = timePass(repeats, [&] { return registryLoop(reg, enemies, probe); }, regHits) * 1000.0;
+        double scalarNs = timePass(repeats, [&] { return scalarLoop(boxes, probe); }, scalarHits) * 1000.0;
+        double kernelNs = timePass(repeats, [&] {
+            return overlapBatch(probe, batch, 0, count, mask.data());
+        }, kernelHits) * 1000.0;
+
+        if (regHits != scalarHits || scalarHits != kernelHits) {
+            std::cerr << "MISMATCH: registry " << regHits << ", scalar " << scalarHits
+                      << ", kernel " << kernelHits << " hits" << std::endl;
+            return 1;
+        }
+
+        std::cout << std::setw(8) << count << std::fixed << std::setprecision(1)
+                  << std::setw(16) << regNs << std::setw(14) << scalarNs
+                  << std::setw(14) << kernelNs
+                  << std::setw(9) << std::setprecision(2) << (regNs / kernelNs) << "x" << std::endl;
+    }
+    return 0;
+}
+
+// Boss-like silhouette: hitboxes picked on a 12px lattice inside a 200x160 hull
+std::vector<AABB> makeHitboxes(std::size_t count, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::vector<AABB> cells;
+    for (int y = 0; y < 160; y += 12) {
+        for (int x = 0; x < 200; x += 12) {
+            cells.push_back(AABB::fromRect(static_cast<float>(x), static_cast<float>(y), 14.0f, 14.0f));
+        }
+    }
+    std::shuffle(cells.begin(), cells.end(), gen);
+    if (cells.size() > count) cells.resize(count);
+    return cells;
+}
+
+int runCompoundBench(int iterations) {
+    std::cout << std::endl;
+    std::cout << "Compound collider, bullet probes around one boss" << std::endl;
+    std::cout << std::setw(10) << "hitboxes" << std::setw(10) << "nodes"
+              << std::setw(14) << "flat (ns)" << std::setw(14) << "bvh (ns)"
+              << std::setw(18) << "4 simple (ns)" << std::setw(14) << "hits b/s" << std::endl;
+
+    // Bullet probes spread over and around the boss area
+    std::mt19937 gen(7u);
+    std::uniform_real_distribution<float> xDist(-50.0f, 250.0f);
+    std::uniform_real_distribution<float> yDist(-50.0f, 210.0f);
+    std::vector<AABB> probes;
+    for (int i = 0; i < 1000; ++i) {
+        probes.push_back(AABB::fromRect(xDist(gen), yDist(gen), 8.0f, 2.0f));
+    }
+    // "A few simple enemies" reference: 4 regular 40x40 enemies in the same area
+    const AABB simpleEnemies[] = {
+        AABB::fromRect(20.0f, 20.0f, 40.0f, 40.0f), AABB::fromRect(140.0f, 20.0f, 40.0f, 40.0f),
+        AABB::fromRect(20.0f, 100.0f, 40.0f, 40.0f), AABB::fromRect(140.0f, 100.0f, 40.0f, 40.0f)
+    };
+
+    const std::size_t counts[] = {8, 32, 64, 128, 200};
+    for (std::size_t count : counts) {
+        std::vector<AABB> hitboxes = makeHitboxes(count, 99u);
+        ColliderShape shape(hitboxes);
+
+        std::size_t flatHits = 0, bvhHits = 0, simpleHits = 0;
+        double flatNs = timePass(iterations, [&] {
+            std::size_t hits = 0;
+            for (const AABB& probe : probes) {
+                for (const AABB& box : hitboxes) {
+                    if (aabbOverlap(probe, box)) { ++hits; break; }
+                }
+            }
+            return hits;
+        }, flatHits) * 1000.0 / probes.size();
+        double bvhNs = timePass(iterations, [&] {
+            std::size_t hits = 0;
+            for (const AABB& probe : probes) {
+                if (aabbOverlap(probe, shape.bounds()) && shape.overlaps(probe)) ++hits;
+            }
+            return hits;
+        }, bvhHits) * 1000.0 / probes.size();
+        double simpleNs = timePass(iterations, [&] {
+            std::size_t hits = 0;
+            for (const AABB& probe : probes) {
+                for (const AABB& enemy : simpleEnemies) {
+                    if (aabbOverlap(probe, enemy)) { ++hits; break; }
+                }
+            }
+            return hits;
+        }, simpleHits) * 1000.0 / probes.size();
+
+        if (flatHits != bvhHits) {
+            std::cerr << "MISMATCH: flat " << flatHits << " hits, bvh " << bvhHits << std::endl;
+            return 1;
+        }
+
+        std::cout << std::setw(10) << shape.boxCount() << std::setw(10) << shape.nodeCount()
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(14) << flatNs << std::setw(14) << bvhNs
+                  << std::setw(18) << simpleNs
+                  << std::setw(8) << bvhHits << "/" << simpleHits << std::endl;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iterations = 200;
+    if (argc > 1) {
+        try {
+            iterations = std::max(1, std::stoi(argv[1]));
+        } catch (const std::exception&) {
+            std::cerr << "Usage: " << argv[0] << " [iterations]" << std::endl;
+            return 1;
+        }
+    }
+
+    SpatialHash grid(0.0f, 0.0f, 800.0f, 600.0f, 64.0f);
+
+    std::cout << "Collision pass, average over " << iterations << " iterations" << std::endl;
+    std::cout << std::setw(8) << "bullets" << std::setw(8) << "enemies"
+              << std::setw(14) << "brute (us)" << std::setw(14) << "grid (us)"
+              << std::setw(10) << "speedup" << std::setw(16) << "grid ns/bullet" << std::endl;
+
+    const std::size_t counts[][2] = {
+        {50, 10}, {100, 25}, {250, 50}, {500, 100}, {1000, 200}, {2000, 400}, {4000, 800}
+    };
+
+    for (const auto& count : counts) {
+        Scene scene = makeScene(count[0], count[1], 1234u);
+
+        std::size_t bruteHits = 0;
+        std::size_t gridHits = 0;
+        double bruteUs = timePass(iterations, [&] { return bruteForcePass(scene); }, bruteHits);
+        double gridUs = timePass(iterations, [&] { return gridPass(scene, grid); }, gridHits);
+
+        if (bruteHits != gridHits) {
+            std::cerr << "MISMATCH: brute force found " << bruteHits
+                      << " hits, grid found " << gridHits << std::endl;
+            return 1;
+        }
+
+        std::cout << std::setw(8) << count[0] << std::setw(8) << count[1]
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(14) << bruteUs << std::setw(14) << gridUs
+                  << std::setw(9) << (bruteUs / gridUs) << "x"
+                  << std::setw(16) << (gridUs * 1000.0 / count[0]) << std::endl;
+    }
+
+    if (runKernelBench(iterations) != 0) return 1;
+    return runCompoundBench(iterations);
+}
@@ -0,0 +1,159 @@
+// Mass-death micro-benchmark
+//
+// Spawns a world of enemies and bullets with the server's components, then
+// kills a large share of them in one tick (screen-clear bomb, wave leaving
+// the screen) and times the destroy pass:
+//  - vector: category membership in std::vector, erased with std::remove
+//    per destroyed entity (what GameServer::destroyEntity used to do)
+//  - set:    category membership in EntitySet (O(1) swap-remove)
+// Both include registry::kill_entity, so the numbers are the full per-tick
+// cost of the deaths apart from the network messages.
+//
+// Usage: ./bench_entities [iterations]
+
+#include "../include/EntitySet.hpp"
+#include "../include/Registry.hpp"
+#include "../include/Components.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct World {
+    registry reg;
+    std::vector<Entity> enemies;
+    std::vector<Entity> bullets;
+    EntitySet enemySet;
+    EntitySet bulletSet;
+};
+
+void buildWorld(World& world, std::size_t enemyCount, std::size_t bulletCount) {
+    registry& reg = world.reg;
+    reg.register_component<Position>();
+    reg.register_component<Velocity>();
+    reg.register_component<Drawable>();
+    reg.register_component<NetworkId>();
+    reg.register_component<EntityTypeTag>();
+    reg.register_component<Health>();
+    reg.register_component<Damage>();
+    reg.register_component<Lifetime>();
+
+    uint32_t networkId = 1;
+    for (std::size_t i = 0; i < enemyCount + bulletCount; ++i) {
+        Entity e = reg.spawn_entity();
+        bool enemy = (i % 2 == 0 && world.enemies.size() < enemyCount) || world.bullets.size() >= bulletCount;
+        reg.add_component<Position>(e, Position{static_cast<float>(i % 800), static_cast<float>(i % 600)});
+        reg.add_component<Velocity>(e, Velocity{enemy ? -150.0f : 400.0f, 0.0f});
+        reg.add_component<Drawable>(e, Drawable{enemy ? 40.0f : 8.0f, enemy ? 40.0f : 2.0f, Color{255, 0, 0}});
+        reg.add_component<NetworkId>(e, NetworkId{networkId++});
+        if (enemy) {
+            reg.add_component<EntityTypeTag>(e, EntityTypeTag{EntityTypeTag::ENEMY});
+            reg.add_component<Health>(e, Health{50, 50});
+            world.enemies.push_back(e);
+            world.enemySet.insert(e);
+        } else {
+            reg.add_component<EntityTypeTag>(e, EntityTypeTag{EntityTypeTag::BULLET_PLAYER});
+            reg.add_component<Damage>(e, Damage{25});
+            reg.add_component<Lifetime>(e, Lifetime{3.0f});
+            world.bullets.push_back(e);
+            world.bulletSet.insert(e);
+        }
+    }
+}
+
+// Picks the entities dying this tick: every enemy (bomb) plus a share of bullets
+std::vector<Entity> pickDeaths(const World& world, double bulletShare, uint32_t seed) {
+    std::vector<Entity> deaths = world.enemies;
+    std::vector<Entity> bullets = world.bullets;
+    std::mt19937 gen(seed);
+    std::shuffle(bullets.begin(), bullets.end(), gen);
+    std::size_t keep = static_cast<std::size_t>(bullets.size() * bulletShare);
+    deaths.insert(deaths.end(), bullets.begin(), bullets.begin() + keep);
+    std::shuffle(deaths.begin(), deaths.end(), gen);
+    return deaths;
+}
+
+template <typename Pass>
+double timeTicks(int iterations, std::size_t enemyCount, std::size_t bulletCount, Pass&& pass) {
+    double totalUs = 0.0;
+    for (int i = 0; i < iterations; ++i) {
+        World world;
+        buildWorld(world, enemyCount, bulletCount);
+        std::vector<Entity> deaths = pickDeaths(world, 0.5, static_cast<uint32_t>(i + 1));
+
+        auto start = std::chrono::steady_clock::now();
+        pass(world, deaths);
+        auto end = std::chrono::steady_clock::now();
+        totalUs += std::chrono::duration<double, std::micro>(end - start).count();
+    }
+    return totalUs / iterations;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int iterations = 5;
+    if (argc > 1) {
+        try {
+            iterations = std::max(1, std::stoi(argv[1]));
+        } catch (const std::exception&) {
+            std::cerr << "Usage: " << argv[0] << " [iterations]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Mass death in one tick (all enemies + half the bullets), average over "
+              << iterations << " iterations" << std::endl;
+    std::cout << std::setw(10) << "entities" << std::setw(10) << "deaths"
+              << std::setw(14) << "vector (us)" << std::setw(12) << "set (us)"
+              << std::setw(10) << "speedup" << std::setw(16) << "set ns/death" << std::endl;
+
+    const std::size_t counts[] = {1000, 4000, 16000, 32000};
+    for (std::size_t total : counts) {
+        std::size_t enemyCount = total / 2;
+        std::size_t bulletCount = total - enemyCount;
+        std::size_t deathCount = enemyCount + bulletCount / 2;
+
+        std::size_t vectorLeft = 0;
+        double vectorUs = timeTicks(iterations, enemyCount, bulletCount, [&](World& world, const std::vector<Entity>& deaths) {
+            std::vector<Entity>& enemies = world.enemies;
+            std::vector<Entity>& bullets = world.bullets;
+            for (Entity e : deaths) {
+                enemies.erase(std::remove(enemies.begin(), enemies.end(), e), enemies.end());
+                bullets.erase(std::remove(bullets.begin(), bullets.end(), e), bullets.end());
+                world.reg.kill_entity(e);
+            }
+            vectorLeft = enemies.size() + bullets.size();
+        });
+
+        std::size_t setLeft = 0;
+        double setUs = timeTicks(iterations, enemyCount, bulletCount, [&](World& world, const std::vector<Entity>& deaths) {
+            EntitySet& enemies = world.enemySet;
+            EntitySet& bullets = world.bulletSet;
+            for (Entity e : deaths) {
+                enemies.erase(e);
+                bullets.erase(e);
+                world.reg.kill_entity(e);
+            }
+            setLeft = enemies.size() + bullets.size();
+        });
+
+        if (vectorLeft != setLeft) {
+            std::cerr << "Mismatch: " << vectorLeft << " vs " << setLeft << " survivors" << std::endl;
+            return 1;
+        }
+
+        std::cout << std::setw(10) << total << std::setw(10) << deathCount
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(14) << vectorUs << std::setw(12) << setUs
+                  << std::setw(9) << std::setprecision(2) << (vectorUs / setUs) << "x"
+                  << std::setw(16) << std::setprecision(1) << (setUs * 1000.0 / deathCount) << std::endl;
+    }
+
+    return 0;
+}
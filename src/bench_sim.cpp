@@ -0,0 +1,277 @@
+// Simulation benchmark driven by an input trace
+//
+// Runs the server's per-room simulation headless (no sockets, no clock):
+// the world a room would build, fed the connections, inputs and ticks of a
+// trace, with the snapshot fill the room does after every tick. Ticks run
+// back to back as fast as possible. The trace is either a match recorded
+// by the server (see Recording.hpp, `r-type_server ... --record-dir <dir>`)
+// or a synthetic one: players flying around and shooting, generated from a
+// seed, with the regular enemy spawner. The whole trace is loaded before
+// timing starts.
+//
+// Reports ticks per second, the time of each tick phase (TickProfile), the
+// entity counts over time and the size of the snapshots on the wire, in full
+// and as deltas (SnapshotDelta.hpp). A recorded trace also has its checksums
+// verified, so a simulation change that alters the game shows up here too.
+//
+// Usage: ./bench_sim [recording.rec] [threads]
+//        ./bench_sim synthetic [seconds] [players] [seed] [threads]
+
+#include "../include/GameWorld.hpp"
+#include "../include/Recording.hpp"
+#include "../include/SnapshotDelta.hpp"
+#include "../include/WorkerPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int TICK_RATE = 60;
+constexpr uint32_t LEVEL_ID = 1;         // GameServer::DEFAULT_LEVEL
+constexpr int REPORT_PERIOD = 10;        // seconds of play between count lines
+constexpr uint32_t DELTA_LAG = 6;        // ticks between a snapshot and its baseline (~100 ms ack)
+
+struct Trace {
+    RecordingHeader header;
+    std::vector<RecordedEvent> events;
+};
+
+// Players change direction every 0.5-1.5 s and hold fire most of the time
+Trace syntheticTrace(int seconds, int players, uint64_t seed) {
+    Trace trace;
+    trace.header.tickRate = TICK_RATE;
+    trace.header.levelId = LEVEL_ID;
+    trace.header.seed = seed;
+
+    std::mt19937 rng(static_cast<std::mt19937::result_type>(deriveSeed(seed, 100)));
+    std::uniform_int_distribution<int> axis(-1, 1);
+    std::uniform_int_distribution<int> hold(TICK_RATE / 2, TICK_RATE * 3 / 2);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::vector<RecordedEvent> current(players);
+    std::vector<int> until(players, 0);
+    for (int p = 0; p < players; ++p) {
+        RecordedEvent connect;
+        connect.type = RecordedEvent::CONNECT;
+        connect.playerId = static_cast<uint8_t>(p + 1);
+        std::snprintf(connect.username, sizeof(connect.username), "Bench%d", p + 1);
+        trace.events.push_back(connect);
+        current[p].type = RecordedEvent::INPUT;
+        current[p].playerId = connect.playerId;
+    }
+
+    for (int tick = 0; tick < seconds * TICK_RATE; ++tick) {
+        for (int p = 0; p < players; ++p) {
+            if (tick >= until[p]) {
+                current[p].moveX = static_cast<int8_t>(axis(rng));
+                current[p].moveY = static_cast<int8_t>(axis(rng));
+                current[p].buttons = unit(rng) < 0.7f ? BTN_SHOOT : 0;
+                current[p].rewindTicks = static_cast<uint8_t>(5 + p * 2);  // 80-180 ms behind
+                until[p] = tick + hold(rng);
+            }
+            trace.events.push_back(current[p]);
+        }
+        RecordedEvent next;
+        next.type = RecordedEvent::TICK;
+        trace.events.push_back(next);
+    }
+    return trace;
+}
+
+bool loadTrace(const std::string& path, Trace& trace) {
+    RecordingReader reader(path);
+    if (!reader.ok()) {
+        std::cerr << "Error: " << path << " is not a readable recording" << std::endl;
+        return false;
+    }
+    trace.header = reader.header();
+    RecordedEvent event;
+    while (reader.next(event)) {
+        trace.events.push_back(event);
+    }
+    if (reader.truncated()) {
+        std::cerr << "Warning: recording is truncated" << std::endl;
+    }
+    return true;
+}
+
+double percentile(std::vector<double> samples, double p) {
+    std::sort(samples.begin(), samples.end());
+    std::size_t i = static_cast<std::size_t>(p * (samples.size() - 1));
+    return samples[i];
+}
+
+int usage(const char* program) {
+    std::cerr << "Usage: " << program << " [recording.rec] [threads]" << std::endl;
+    std::cerr << "       " << program << " synthetic [seconds] [players] [seed] [threads]" << std::endl;
+    return 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Trace trace;
+    std::string source = "synthetic";
+    int threads = 1;
+    try {
+        if (argc > 1 && std::string(argv[1]) != "synthetic") {
+            if (argc > 3) return usage(argv[0]);
+            source = argv[1];
+            if (argc > 2) threads = std::max(1, std::stoi(argv[2]));
+            if (!loadTrace(source, trace)) return 1;
+        } else {
+            if (argc > 6) return usage(argv[0]);
+            int seconds = argc > 2 ? std::max(1, std::stoi(argv[2])) : 120;
+            int players = argc > 3 ? std::min(4, std::max(1, std::stoi(argv[3]))) : 4;
+            uint64_t seed = argc > 4 ? std::stoull(argv[4], nullptr, 0) : 1;
+            if (argc > 5) threads = std::max(1, std::stoi(argv[5]));
+            trace = syntheticTrace(seconds, players, seed);
+        }
+    } catch (const std::exception&) {
+        return usage(argv[0]);
+    }
+
+    const int tickRate = std::max<int>(1, trace.header.tickRate);
+    WorkerPool pool(static_cast<std::size_t>(threads));
+    GameWorld world(tickRate, true, trace.header.levelId, trace.header.seed);
+    if (threads > 1) {
+        world.setWorkerPool(&pool);
+    }
+
+    // The world logs spawns and inputs to stdout: keep it for the report
+    std::streambuf* console = std::cout.rdbuf(nullptr);
+
+    TickProfile profile;
+    double snapshotUs = 0.0;
+    std::vector<double> tickUs;
+    std::vector<EntityBatchEntry> snapshot;
+    std::vector<std::string> counts;
+    std::size_t maxEnemies = 0;
+    std::size_t maxBullets = 0;
+    std::size_t maxEnemyBullets = 0;
+    uint64_t checked = 0;
+    uint64_t mismatches = 0;
+    SnapshotHistory history;
+    const std::vector<EntityBatchEntry> noBaseline;
+    std::vector<DeltaEntry> deltas;
+    double rawBytes = 0.0;
+    double fullBytes = 0.0;
+    double deltaBytes = 0.0;
+    // Bit-packed size of the entries against a baseline (one fragment)
+    auto packedBytes = [&](const std::vector<EntityBatchEntry>& baseline, const std::vector<EntityBatchEntry>& now) {
+        deltas.clear();
+        diffSnapshots(baseline, now, deltas);
+        std::size_t bits = 0;
+        uint32_t previousId = 0;
+        for (const DeltaEntry& delta : deltas) {
+            bits += deltaEntryBits(delta, previousId);
+            previousId = delta.state.networkId;
+        }
+        return static_cast<double>((bits + 7) / 8);
+    };
+
+    auto periodStart = std::chrono::steady_clock::now();
+    auto start = periodStart;
+    for (const RecordedEvent& event : trace.events) {
+        if (event.type == RecordedEvent::CHECKSUM) {
+            ++checked;
+            mismatches += world.checksum() != event.checksum;
+            continue;
+        }
+        if (event.type != RecordedEvent::TICK) {
+            applyRecordedEvent(world, event);
+            continue;
+        }
+
+        // The room's tick: simulation, then the snapshot fill
+        auto tickStart = std::chrono::steady_clock::now();
+        world.tick(profile);
+        auto simulated = std::chrono::steady_clock::now();
+        snapshot.clear();
+        world.fillSnapshot(snapshot);
+        auto end = std::chrono::steady_clock::now();
+        world.clearEvents();
+
+        // Untimed: the sender thread encodes, not the tick
+        uint32_t tick = static_cast<uint32_t>(world.tickCount());
+        std::vector<EntityBatchEntry>& sorted = history.store(tick);
+        sorted = snapshot;
+        quantizeSnapshot(sorted);
+        sortByNetworkId(sorted);
+        const std::vector<EntityBatchEntry>* baseline = history.find(tick - DELTA_LAG);
+        rawBytes += static_cast<double>(snapshot.size() * sizeof(EntityBatchEntry));
+        fullBytes += packedBytes(noBaseline, sorted);
+        deltaBytes += packedBytes(baseline ? *baseline : noBaseline, sorted);
+
+        tickUs.push_back(std::chrono::duration<double, std::micro>(end - tickStart).count());
+        snapshotUs += std::chrono::duration<double, std::micro>(end - simulated).count();
+        maxEnemies = std::max(maxEnemies, world.enemyCount());
+        maxBullets = std::max(maxBullets, world.playerBulletCount());
+        maxEnemyBullets = std::max(maxEnemyBullets, world.enemyBulletCount());
+
+        if (tickUs.size() % static_cast<std::size_t>(REPORT_PERIOD * tickRate) == 0) {
+            double seconds = std::chrono::duration<double>(end - periodStart).count();
+            periodStart = end;
+            std::ostringstream line;
+            line << "  " << std::setw(5) << tickUs.size() / tickRate << " s   enemies " << std::setw(4)
+                 << world.enemyCount() << "   player bullets " << std::setw(4) << world.playerBulletCount()
+                 << "   enemy bullets " << std::setw(6) << world.enemyBulletCount() << "   "
+                 << std::setw(8) << static_cast<long>(REPORT_PERIOD * tickRate / seconds) << " ticks/s";
+            counts.push_back(line.str());
+        }
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout.rdbuf(console);
+    std::cout.clear();
+
+    if (tickUs.empty()) {
+        std::cerr << "Error: the trace has no ticks" << std::endl;
+        return 1;
+    }
+
+    double ticks = static_cast<double>(tickUs.size());
+    double total = 0.0;
+    for (double us : tickUs) total += us;
+
+    std::cout << "Simulation: " << source << ", " << tickRate << " Hz, level " << trace.header.levelId
+              << ", seed " << trace.header.seed << ", " << tickUs.size() << " ticks ("
+              << ticks / tickRate << " s of play), " << collisionKernelName() << " kernel, " << threads
+              << " thread" << (threads > 1 ? "s" : "") << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Entity counts:" << std::endl;
+    for (const auto& line : counts) std::cout << line << std::endl;
+    std::cout << "  peak: enemies " << maxEnemies << ", player bullets " << maxBullets
+              << ", enemy bullets " << maxEnemyBullets << std::endl;
+
+    std::cout << "Throughput: " << static_cast<long>(ticks / wall) << " ticks/s ("
+              << ticks / tickRate / wall << "x real time)" << std::endl;
+    std::cout << std::setprecision(2);
+    std::cout << "Tick (us): mean " << total / ticks << ", p50 " << percentile(tickUs, 0.5) << ", p99 "
+              << percentile(tickUs, 0.99) << ", max " << *std::max_element(tickUs.begin(), tickUs.end())
+              << std::endl;
+    std::cout << "Phases (mean us per tick, share of the tick):" << std::endl;
+    auto phaseLine = [&](const char* name, double us) {
+        std::cout << "  " << std::left << std::setw(14) << name << std::right << std::setw(9)
+                  << us / ticks << "  " << std::setw(5) << std::setprecision(1) << 100.0 * us / total
+                  << "%" << std::setprecision(2) << std::endl;
+    };
+    for (int phase = 0; phase < TickProfile::PHASE_COUNT; ++phase) {
+        phaseLine(TickProfile::name(static_cast<TickProfile::Phase>(phase)), profile.us[phase]);
+    }
+    phaseLine("snapshot fill", snapshotUs);
+    std::cout << std::setprecision(0) << "Snapshot entries (mean bytes): " << rawBytes / ticks
+              << " as EntityBatchEntry, " << fullBytes / ticks << " bit-packed, " << deltaBytes / ticks
+              << " as a delta against " << DELTA_LAG << " ticks back" << std::endl;
+
+    if (checked > 0) {
+        std::cout << "Checksums: " << (checked - mismatches) << "/" << checked << " match" << std::endl;
+    }
+    return mismatches == 0 ? 0 : 2;
+}
@@ -227,6 +227,8 @@ private:
         payload.buttons = buttons;
         payload.moveX = moveX;
         payload.moveY = moveY;
+        payload.sequence = _inputSequence++;
+        payload.snapshotTick = 0;  // Ne lit pas les snapshots : pas de compensation de latence
 
         char packet[sizeof(PacketHeader) + sizeof(PlayerInputPayload)];
         std::memcpy(packet, &header, sizeof(PacketHeader));
@@ -261,6 +263,7 @@ private:
     short _udpPort;
     uint8_t _playerId;
     uint32_t _sessionToken;
+    uint32_t _inputSequence{0};
     std::atomic<bool> _running;
     struct termios _oldTermios;
 };
@@ -1,17 +1,46 @@
 #include "../include/GameServer.hpp"
 #include <iostream>
 #include <cstdlib>
+#include <optional>
+#include <string>
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " <tcp_port> <udp_port> [options]" << std::endl;
+    std::cerr << "Options:" << std::endl;
+    std::cerr << "  --tick-rate <hz>        simulation rate, 1-240 (default " << GameServer::DEFAULT_TICK_RATE << ")" << std::endl;
+    std::cerr << "  --policy <catchup|skip> what to do with ticks that overran (default catchup)" << std::endl;
+    std::cerr << "  --workers <n>           worker threads, 1-64 (default: one per hardware thread)" << std::endl;
+    std::cerr << "  --snapshot-rate <hz>    snapshots per second per client, 1-tick rate (default: every tick)" << std::endl;
+    std::cerr << "  --seed <n>              world seed (default: random, logged at startup)" << std::endl;
+    std::cerr << "  --record-dir <dir>      record every match there (default: not recorded)" << std::endl;
+    std::cerr << "  --datagram-size <bytes> snapshot packet size, " << MIN_DATAGRAM_SIZE << "-" << MAX_DATAGRAM_SIZE
+              << " (default " << DEFAULT_SNAPSHOT_DATAGRAM << ")" << std::endl;
+    std::cerr << "Example: " << program << " 4242 4243" << std::endl;
+    std::cerr << "         " << program << " 4242 4243 --tick-rate 30" << std::endl;
+    std::cerr << "         " << program << " 4242 4243 --workers 4 --snapshot-rate 20" << std::endl;
+    std::cerr << "         " << program << " 4242 4243 --seed 1234 --record-dir recordings" << std::endl;
+}
+
+}  // namespace
 
 int main(int argc, char **argv) {
     try {
-        if (argc != 3) {
-            std::cerr << "Usage: " << argv[0] << " <tcp_port> <udp_port>" << std::endl;
-            std::cerr << "Example: " << argv[0] << " 4242 4243" << std::endl;
+        if (argc < 3) {
+            printUsage(argv[0]);
             return 1;
         }
 
         short tcpPort;
         short udpPort;
+        int tickRate = GameServer::DEFAULT_TICK_RATE;
+        GameServer::OverrunPolicy overrunPolicy = GameServer::OverrunPolicy::CatchUp;
+        std::size_t workerThreads = 0;  // One per hardware thread
+        int snapshotRate = 0;           // One snapshot per tick
+        std::optional<uint64_t> seed;   // Random, logged at startup
+        std::string recordDir;          // Matches not recorded
+        std::size_t datagramSize = DEFAULT_SNAPSHOT_DATAGRAM;
         try {
             int tcp = std::stoi(argv[1]);
             int udp = std::stoi(argv[2]);
@@ -21,13 +50,75 @@ int main(int argc, char **argv) {
             }
             tcpPort = static_cast<short>(tcp);
             udpPort = static_cast<short>(udp);
+
+            // Every option takes a value
+            for (int i = 3; i < argc; i += 2) {
+                std::string option = argv[i];
+                if (i + 1 >= argc) {
+                    std::cerr << "Error: Missing value for " << option << std::endl;
+                    printUsage(argv[0]);
+                    return 1;
+                }
+                std::string value = argv[i + 1];
+                if (option == "--tick-rate") {
+                    tickRate = std::stoi(value);
+                    if (tickRate < 1 || tickRate > 240) {
+                        std::cerr << "Error: Tick rate must be between 1 and 240" << std::endl;
+                        return 1;
+                    }
+                } else if (option == "--policy") {
+                    if (value == "skip") {
+                        overrunPolicy = GameServer::OverrunPolicy::Skip;
+                    } else if (value == "catchup") {
+                        overrunPolicy = GameServer::OverrunPolicy::CatchUp;
+                    } else {
+                        std::cerr << "Error: Overrun policy must be 'catchup' or 'skip'" << std::endl;
+                        return 1;
+                    }
+                } else if (option == "--workers") {
+                    int workers = std::stoi(value);
+                    if (workers < 1 || workers > 64) {
+                        std::cerr << "Error: Worker threads must be between 1 and 64" << std::endl;
+                        return 1;
+                    }
+                    workerThreads = static_cast<std::size_t>(workers);
+                } else if (option == "--snapshot-rate") {
+                    snapshotRate = std::stoi(value);
+                    if (snapshotRate < 1) {
+                        std::cerr << "Error: Snapshot rate must be between 1 and the tick rate" << std::endl;
+                        return 1;
+                    }
+                } else if (option == "--seed") {
+                    seed = std::stoull(value, nullptr, 0);
+                } else if (option == "--record-dir") {
+                    recordDir = value;
+                } else if (option == "--datagram-size") {
+                    int size = std::stoi(value);
+                    if (size < static_cast<int>(MIN_DATAGRAM_SIZE) || size > static_cast<int>(MAX_DATAGRAM_SIZE)) {
+                        std::cerr << "Error: Datagram size must be between " << MIN_DATAGRAM_SIZE << " and "
+                                  << MAX_DATAGRAM_SIZE << std::endl;
+                        return 1;
+                    }
+                    datagramSize = static_cast<std::size_t>(size);
+                } else {
+                    std::cerr << "Error: Unknown option " << option << std::endl;
+                    printUsage(argv[0]);
+                    return 1;
+                }
+            }
+            // Checked once the tick rate is known, whatever the option order
+            if (snapshotRate > tickRate) {
+                std::cerr << "Error: Snapshot rate must be between 1 and the tick rate" << std::endl;
+                return 1;
+            }
         } catch (const std::exception& e) {
-            std::cerr << "Error: Invalid port number" << std::endl;
+            std::cerr << "Error: Invalid port number, tick rate, worker count, snapshot rate, seed or datagram size" << std::endl;
             return 1;
         }
 
         asio::io_context io_context;
-        GameServer server(io_context, tcpPort, udpPort);
+        GameServer server(io_context, tcpPort, udpPort, tickRate, overrunPolicy, workerThreads, snapshotRate,
+                          seed, recordDir, datagramSize);
 
         std::cout << "R-Type Game Server is running..." << std::endl;
         std::cout << "Waiting for clients to connect..." << std::endl;
@@ -13,14 +13,16 @@
 #include <cmath>
 
 int main(int argc, char** argv) {
-    if (argc != 3) {
-        std::cerr << "Usage: " << argv[0] << " <host> <tcp_port>" << std::endl;
+    if (argc < 3 || argc > 4) {
+        std::cerr << "Usage: " << argv[0] << " <host> <tcp_port> [snapshot_rate]" << std::endl;
         std::cerr << "Example: " << argv[0] << " localhost 4242" << std::endl;
+        std::cerr << "         " << argv[0] << " localhost 4242 20" << std::endl;
         return 1;
     }
 
     std::string host = argv[1];
     short tcpPort;
+    int snapshotRate = 0;  // As many as the server sends
     try {
         int port = std::stoi(argv[2]);
         if (port <= 0 || port > 65535) {
@@ -28,8 +30,15 @@ int main(int argc, char** argv) {
             return 1;
         }
         tcpPort = static_cast<short>(port);
+        if (argc == 4) {
+            snapshotRate = std::stoi(argv[3]);
+            if (snapshotRate < 1) {
+                std::cerr << "Error: Snapshot rate must be at least 1" << std::endl;
+                return 1;
+            }
+        }
     } catch (const std::exception& e) {
-        std::cerr << "Error: Invalid port number: " << argv[2] << std::endl;
+        std::cerr << "Error: Invalid port number or snapshot rate" << std::endl;
         return 1;
     }
 
@@ -43,7 +52,7 @@ int main(int argc, char** argv) {
 
     // Create client and connect
     GameClient client(host, tcpPort);
-    if (!client.connect(username)) {
+    if (!client.connect(username, snapshotRate)) {
         std::cerr << "Failed to connect to server" << std::endl;
         return 1;
     }
@@ -183,6 +192,23 @@ int main(int argc, char** argv) {
             }
         }
 
+        // Draw the terrain tiles on screen (generated from the level ID,
+        // scrolled in step with the server)
+        const TileMap& terrain = client.getTerrain();
+        if (!terrain.empty()) {
+            float tile = terrain.tileSize();
+            float scroll = client.getScroll();
+            int firstColumn = (int)std::floor(scroll / tile);
+            int visibleColumns = (int)(800.0f / tile) + 2;
+            for (int c = firstColumn; c < firstColumn + visibleColumns; ++c) {
+                for (int r = 0; r < terrain.rows(); ++r) {
+                    if (terrain.solid(c, r)) {
+                        DrawRectangle((int)(c * tile - scroll), (int)(r * tile), (int)tile, (int)tile, DARKGRAY);
+                    }
+                }
+            }
+        }
+
         // Draw all entities
         int drawnCount = 0;
         for (const auto& [networkId, entity] : client.getEntities()) {
@@ -0,0 +1,97 @@
+// Match replay
+//
+// Rebuilds the world a recording was made from (tick rate, level, seed) and
+// applies the recorded connections, inputs and ticks, with no network and
+// no clock. Every CHECKSUM of the recording is compared with the replayed
+// world: a mismatch means the simulation is not deterministic or changed
+// since the recording was made (recordings only replay exactly on the
+// build that made them).
+//
+// With threads > 1 the enemy bullet strips run on a worker pool of that
+// size, which must not change the result.
+//
+// Usage: ./r-type_replay <recording> [threads]
+
+#include "../include/GameWorld.hpp"
+#include "../include/Recording.hpp"
+#include "../include/WorkerPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " <recording> [threads]" << std::endl;
+        return 1;
+    }
+    int threads = 1;
+    try {
+        if (argc > 2) threads = std::max(1, std::stoi(argv[2]));
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " <recording> [threads]" << std::endl;
+        return 1;
+    }
+
+    RecordingReader reader(argv[1]);
+    if (!reader.ok()) {
+        std::cerr << "Error: " << argv[1] << " is not a readable recording" << std::endl;
+        return 1;
+    }
+    const RecordingHeader& header = reader.header();
+    std::cout << "Recording: " << header.tickRate << " Hz, level " << header.levelId
+              << ", seed " << header.seed << std::endl;
+
+    WorkerPool pool(static_cast<std::size_t>(threads));
+    GameWorld world(header.tickRate, true, header.levelId, header.seed);
+    if (threads > 1) {
+        world.setWorkerPool(&pool);
+    }
+
+    uint64_t ticks = 0;
+    uint64_t inputs = 0;
+    uint64_t checked = 0;
+    uint64_t mismatches = 0;
+    RecordedEvent event;
+    auto start = std::chrono::steady_clock::now();
+    while (reader.next(event)) {
+        switch (event.type) {
+            case RecordedEvent::TICK:
+                ++ticks;
+                break;
+            case RecordedEvent::INPUT:
+            case RecordedEvent::REPEAT:
+                ++inputs;
+                break;
+            case RecordedEvent::CHECKSUM: {
+                ++checked;
+                uint64_t actual = world.checksum();
+                if (actual != event.checksum) {
+                    if (mismatches == 0) {
+                        std::cerr << "Mismatch at tick " << world.tickCount() << ": recorded " << std::hex
+                                  << event.checksum << ", replayed " << actual << std::dec << std::endl;
+                    }
+                    ++mismatches;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        applyRecordedEvent(world, event);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (reader.truncated()) {
+        std::cerr << "Warning: recording is truncated, replayed up to tick " << world.tickCount() << std::endl;
+    }
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Replayed " << ticks << " ticks (" << ticks / static_cast<double>(header.tickRate)
+              << " s of play), " << inputs << " inputs in " << seconds * 1000.0 << " ms" << std::endl;
+    std::cout << "Final state: tick " << world.tickCount() << ", " << world.enemyCount() << " enemies, "
+              << world.enemyBulletCount() << " enemy bullets, checksum " << std::hex << world.checksum()
+              << std::dec << std::endl;
+    std::cout << "Checksums: " << (checked - mismatches) << "/" << checked << " match" << std::endl;
+    return mismatches == 0 ? 0 : 2;
+}
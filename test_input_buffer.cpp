@@ -0,0 +1,226 @@
+// Tests of the per-player input jitter buffer (no network)
+//
+// Inputs are pushed as they would reach the server (one per tick, shuffled,
+// with gaps, in bursts, late or twice) and read back one per tick as the
+// room does. Exits with 1 on the first failed check.
+
+#include "../include/InputBuffer.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+int checks = 0;
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        ++checks;                                                                         \
+        if (!(condition)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": FAILED: " #condition << std::endl; \
+            std::exit(1);                                                                 \
+        }                                                                                 \
+    } while (0)
+
+// 20 ms ticks: a client sending one input per frame has no jitter at all
+constexpr int TICK_RATE = 50;
+constexpr uint32_t TICK_MS = 1000 / TICK_RATE;
+
+BufferedInput makeInput(uint32_t sequence, uint8_t buttons = 0) {
+    BufferedInput input;
+    input.sequence = sequence;
+    input.timestamp = sequence * TICK_MS;
+    input.moveX = static_cast<int8_t>(sequence % 3) - 1;
+    input.buttons = buttons;
+    input.snapshotTick = sequence;
+    return input;
+}
+
+// One input per tick, played on the tick it arrives: sequences 1..count
+void playSteady(InputBuffer& buffer, uint32_t count, uint64_t& tick) {
+    BufferedInput out;
+    for (uint32_t sequence = 1; sequence <= count; ++sequence, ++tick) {
+        buffer.push(makeInput(sequence), tick);
+        CHECK(buffer.next(out));
+        CHECK(out.sequence == sequence);
+    }
+}
+
+void testInOrder() {
+    InputBuffer buffer(TICK_RATE);
+    BufferedInput out;
+    CHECK(!buffer.next(out));  // Nothing received yet
+
+    uint64_t tick = 0;
+    buffer.push(makeInput(1, 0x1), tick);
+    CHECK(buffer.next(out));
+    CHECK(out.sequence == 1 && out.buttons == 0x1 && out.moveX == 0 && out.snapshotTick == 1);
+    ++tick;
+
+    for (uint32_t sequence = 2; sequence <= 100; ++sequence, ++tick) {
+        buffer.push(makeInput(sequence), tick);
+        CHECK(buffer.next(out));
+        CHECK(out.sequence == sequence && out.timestamp == sequence * TICK_MS);
+    }
+    CHECK(buffer.target() == 0);
+    CHECK(buffer.depth() == 0);
+    CHECK(buffer.lost() == 0 && buffer.repeated() == 0 && buffer.skipped() == 0);
+}
+
+void testShuffled(std::mt19937& rng) {
+    // Inputs sent one per tick arrive in shuffled windows of 4; reading
+    // starts a few ticks late. Sequences come out in order, and every input
+    // is accounted for once: played, skipped, or lost when it arrived after
+    // a newer one was played.
+    const uint32_t count = 200;
+    std::vector<uint32_t> arrival(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        arrival[i] = i + 1;
+    }
+    for (uint32_t i = 0; i < count; i += 4) {
+        std::shuffle(arrival.begin() + i, arrival.begin() + i + 4, rng);
+    }
+
+    InputBuffer buffer(TICK_RATE);
+    std::vector<uint32_t> played;
+    BufferedInput out;
+    for (uint64_t tick = 0; tick < count + 20; ++tick) {
+        if (tick < count) {
+            uint32_t sequence = arrival[tick];
+            buffer.push(makeInput(sequence), tick);
+        }
+        if (tick >= 4) {
+            CHECK(buffer.next(out));
+            if (played.empty() || out.sequence != played.back()) {
+                played.push_back(out.sequence);
+            }
+        }
+    }
+    for (std::size_t i = 1; i < played.size(); ++i) {
+        CHECK(played[i] > played[i - 1]);
+    }
+    CHECK(played.back() == count);
+    CHECK(buffer.target() > 0);  // Reordering counts as jitter
+    CHECK(played.size() + buffer.skipped() + buffer.lost() == count);
+}
+
+void testGapRepeats() {
+    // The buffer runs dry: the last input is played again until a newer one
+    // arrives, and the sequences that never came count as lost
+    InputBuffer buffer(TICK_RATE);
+    uint64_t tick = 0;
+    playSteady(buffer, 10, tick);
+    BufferedInput last;
+    buffer.push(makeInput(11, 0x2), tick++);
+    CHECK(buffer.next(last));
+
+    BufferedInput out;
+    for (int i = 0; i < 3; ++i, ++tick) {
+        CHECK(buffer.next(out));
+        CHECK(out.sequence == 11 && out.buttons == 0x2 && out.moveX == last.moveX);
+    }
+    CHECK(buffer.repeated() == 3);
+
+    buffer.push(makeInput(15), tick);  // 12, 13 and 14 were lost
+    CHECK(buffer.next(out));
+    CHECK(out.sequence == 15);
+    CHECK(buffer.lost() == 3);
+    CHECK(buffer.skipped() == 0);
+}
+
+void testBurstSkips() {
+    // Five inputs held back by the network arrive on the same tick: the
+    // buffer keeps target + 1 of them and skips the rest, whose buttons are
+    // merged into the input played
+    InputBuffer buffer(TICK_RATE);
+    uint64_t tick = 0;
+    playSteady(buffer, 10, tick);
+    CHECK(buffer.target() == 0);
+
+    const uint8_t buttons[] = {0x1, 0x2, 0x4, 0x8, 0x10};
+    for (uint32_t i = 0; i < 5; ++i) {
+        buffer.push(makeInput(11 + i, buttons[i]), tick);
+    }
+    std::size_t kept = buffer.target() + 1;
+    CHECK(kept < 5);
+    uint32_t skipped = static_cast<uint32_t>(5 - kept);
+
+    BufferedInput out;
+    CHECK(buffer.next(out));
+    CHECK(out.sequence == 11 + skipped);
+    uint8_t merged = 0;
+    for (uint32_t i = 0; i <= skipped; ++i) {
+        merged |= buttons[i];
+    }
+    CHECK(out.buttons == merged);
+    CHECK(buffer.skipped() == skipped);
+    CHECK(buffer.lost() == 0);
+
+    // The rest plays in order, with its own buttons only
+    for (uint32_t sequence = 12 + skipped; sequence <= 15; ++sequence) {
+        CHECK(buffer.next(out));
+        CHECK(out.sequence == sequence && out.buttons == buttons[sequence - 11]);
+    }
+    CHECK(buffer.depth() == 0);
+}
+
+void testReorderAndDropLate() {
+    // Before anything is played, arrivals are sorted by sequence
+    InputBuffer buffer(TICK_RATE);
+    buffer.push(makeInput(3), 0);
+    buffer.push(makeInput(1), 0);
+    buffer.push(makeInput(2), 0);
+    buffer.push(makeInput(2), 0);  // Duplicate of a queued input
+    CHECK(buffer.depth() == 3);
+
+    BufferedInput out;
+    uint32_t expected = 1 + static_cast<uint32_t>(3 - std::min<std::size_t>(3, buffer.target() + 1));
+    CHECK(buffer.next(out));
+    CHECK(out.sequence == expected);
+    while (buffer.depth() > 0) {
+        CHECK(buffer.next(out));
+        CHECK(out.sequence == ++expected);
+    }
+    CHECK(out.sequence == 3);
+
+    // Inputs older than the last one played, or equal to it, are dropped
+    buffer.push(makeInput(1), 1);
+    buffer.push(makeInput(3), 1);
+    CHECK(buffer.depth() == 0);
+    CHECK(buffer.next(out));
+    CHECK(out.sequence == 3);
+    CHECK(buffer.repeated() == 1);
+
+    // Sequence numbers wrap around
+    InputBuffer wrapping(TICK_RATE);
+    uint32_t sequence = 0xFFFFFFFEu;
+    for (uint64_t tick = 0; tick < 4; ++tick, ++sequence) {
+        BufferedInput input = makeInput(0);
+        input.sequence = sequence;
+        input.timestamp = static_cast<uint32_t>(tick) * TICK_MS;
+        wrapping.push(input, tick);
+        CHECK(wrapping.next(out));
+        CHECK(out.sequence == sequence);
+    }
+    BufferedInput stale = makeInput(0);
+    stale.sequence = 0xFFFFFFFFu;
+    wrapping.push(stale, 4);
+    CHECK(wrapping.depth() == 0);
+    CHECK(wrapping.lost() == 0);
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 rng(42);
+    testInOrder();
+    testShuffled(rng);
+    testGapRepeats();
+    testBurstSkips();
+    testReorderAndDropLate();
+    std::cout << "Input buffer: " << checks << " checks passed" << std::endl;
+    return 0;
+}
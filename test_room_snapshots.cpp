@@ -0,0 +1,104 @@
+// Snapshot delivery of a Room to its sender (localhost UDP, no server)
+//
+// Two clients get a snapshot every other tick, on alternate ticks. The room
+// is ticked twice before each send, so the second snapshot overwrites the
+// first in the triple buffer: both clients must still receive one. Exits
+// with 1 on the first failed check.
+
+#include "../include/Room.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+int checks = 0;
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        ++checks;                                                                         \
+        if (!(condition)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": FAILED: " #condition << std::endl; \
+            std::exit(1);                                                                 \
+        }                                                                                 \
+    } while (0)
+
+constexpr int TICK_RATE = 60;
+constexpr int SNAPSHOT_RATE = 30;   // Every other tick
+constexpr int ROUNDS = 20;
+
+// Reads every datagram waiting on the socket; returns the number of
+// ENTITY_BATCH_UPDATE fragments among them
+int drainSnapshots(asio::ip::udp::socket& socket) {
+    // Loopback delivery is immediate, the wait only covers a slow machine
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+    int snapshots = 0;
+    char data[MAX_DATAGRAM_SIZE];
+    asio::ip::udp::endpoint from;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (socket.available() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        std::size_t size = socket.receive_from(asio::buffer(data), from);
+        PacketHeader header;
+        CHECK(size >= sizeof(PacketHeader));
+        std::memcpy(&header, data, sizeof(PacketHeader));
+        if (header.type == ENTITY_BATCH_UPDATE) {
+            ++snapshots;
+        }
+    }
+    return snapshots;
+}
+
+NetEvent connectEvent(uint8_t playerId) {
+    NetEvent event;
+    event.type = NetEvent::CONNECT;
+    event.playerId = playerId;
+    event.snapshotRate = SNAPSHOT_RATE;
+    std::strncpy(event.username, "Test", sizeof(event.username) - 1);
+    return event;
+}
+
+NetEvent udpReadyEvent(uint8_t playerId, const asio::ip::udp::endpoint& endpoint) {
+    NetEvent event;
+    event.type = NetEvent::UDP_READY;
+    event.playerId = playerId;
+    event.endpoint = endpoint;
+    return event;
+}
+
+}  // namespace
+
+int main() {
+    asio::io_context io;
+    const asio::ip::udp::endpoint loopback(asio::ip::make_address("127.0.0.1"), 0);
+    asio::ip::udp::socket sender(io, loopback);
+    asio::ip::udp::socket first(io, loopback);
+    asio::ip::udp::socket second(io, loopback);
+
+    Room room(0, TICK_RATE, 1, 42, "", DEFAULT_SNAPSHOT_DATAGRAM, nullptr, [] { return true; });
+    CHECK(room.tryPush(connectEvent(1)));
+    CHECK(room.tryPush(connectEvent(2)));
+    CHECK(room.tryPush(udpReadyEvent(1, first.local_endpoint())));
+    CHECK(room.tryPush(udpReadyEvent(2, second.local_endpoint())));
+
+    // Spawns and the first snapshot
+    room.tick();
+    room.send(sender);
+    drainSnapshots(first);
+    drainSnapshots(second);
+
+    for (int round = 0; round < ROUNDS; ++round) {
+        room.tick();
+        room.tick();
+        room.send(sender);
+        CHECK(drainSnapshots(first) > 0);
+        CHECK(drainSnapshots(second) > 0);
+    }
+
+    std::cout << "Room snapshots: " << checks << " checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,212 @@
+// Round-trip and bounds tests of the snapshot encoding (no network)
+//
+// BitWriter/BitReader, the quantizers and the delta entries of
+// ENTITY_BATCH_UPDATE, fed random data from a fixed seed. Exits with 1 on
+// the first failed check.
+
+#include "../include/BitStream.hpp"
+#include "../include/SnapshotDelta.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+int checks = 0;
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        ++checks;                                                                         \
+        if (!(condition)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": FAILED: " #condition << std::endl; \
+            std::exit(1);                                                                 \
+        }                                                                                 \
+    } while (0)
+
+void testBitRoundTrip(std::mt19937& rng) {
+    std::vector<char> bytes;
+    std::vector<std::pair<uint32_t, unsigned>> fields;
+    BitWriter writer(bytes);
+    for (int i = 0; i < 10000; ++i) {
+        unsigned bits = 1 + rng() % 32;
+        uint32_t value = bits == 32 ? static_cast<uint32_t>(rng()) : static_cast<uint32_t>(rng()) & ((1u << bits) - 1);
+        writer.write(value, bits);
+        fields.emplace_back(value, bits);
+    }
+    std::size_t total = writer.bits();
+    writer.finish();
+    CHECK(bytes.size() == (total + 7) / 8);
+
+    BitReader reader(bytes.data(), bytes.size());
+    for (const auto& field : fields) {
+        CHECK(reader.read(field.second) == field.first);
+    }
+    CHECK(reader.ok());
+    CHECK(reader.remainingBits() < 8);
+}
+
+void testVarUint() {
+    const uint32_t values[] = {0, 1, 15, 16, 255, 256, 65535, 1u << 28, UINT32_MAX};
+    std::vector<char> bytes;
+    BitWriter writer(bytes);
+    std::size_t expected = 0;
+    for (uint32_t value : values) {
+        writer.writeVarUint(value);
+        expected += varUintBits(value);
+        CHECK(writer.bits() == expected);
+    }
+    writer.finish();
+    CHECK(varUintBits(15) == 5 && varUintBits(16) == 10 && varUintBits(UINT32_MAX) == 40);
+
+    BitReader reader(bytes.data(), bytes.size());
+    for (uint32_t value : values) {
+        CHECK(reader.readVarUint() == value);
+    }
+    CHECK(reader.ok());
+}
+
+void testReaderBounds() {
+    const char data[2] = {static_cast<char>(0xFF), 0x01};
+    BitReader reader(data, sizeof(data));
+    CHECK(reader.read(9) == 0x1FF);
+    CHECK(reader.ok());
+    CHECK(reader.read(8) == 0);  // 7 bits left
+    CHECK(!reader.ok());
+
+    BitReader empty(nullptr, 0);
+    CHECK(empty.read(1) == 0);
+    CHECK(!empty.ok());
+
+    // A group that never ends overflows 32 bits
+    const char endless[8] = {-1, -1, -1, -1, -1, -1, -1, -1};
+    BitReader varUint(endless, sizeof(endless));
+    varUint.readVarUint();
+    CHECK(!varUint.ok());
+}
+
+void testQuantizer(std::mt19937& rng) {
+    const Quantizer q{SNAPSHOT_MIN_X, SNAPSHOT_POS_STEP, SNAPSHOT_POS_BITS};
+    const float max = q.dequantize(q.maxValue());
+    CHECK(q.maxValue() == 8191);
+    CHECK(max == SNAPSHOT_MIN_X + 8191 * 0.125f);
+
+    // Inside the range: within half a step, and snapping is stable
+    std::uniform_real_distribution<float> inside(SNAPSHOT_MIN_X, max);
+    for (int i = 0; i < 10000; ++i) {
+        float value = inside(rng);
+        float snapped = q.snap(value);
+        CHECK(std::fabs(snapped - value) <= q.step / 2);
+        CHECK(q.snap(snapped) == snapped);
+        CHECK(q.quantize(value) <= q.maxValue());
+    }
+
+    // Outside: clamped to the ends
+    CHECK(q.quantize(SNAPSHOT_MIN_X - 500.0f) == 0);
+    CHECK(q.quantize(max + 500.0f) == q.maxValue());
+    CHECK(q.quantize(std::nanf("")) == 0);
+    CHECK(q.snap(0.0f) == 0.0f && q.snap(800.0f) == 800.0f && q.snap(-100.0f) == -100.0f);
+    CHECK(SNAPSHOT_HEALTH.quantize(100) == 100 && SNAPSHOT_HEALTH.quantize(255) == 127);
+}
+
+std::vector<EntityBatchEntry> randomSnapshot(std::mt19937& rng, const std::vector<EntityBatchEntry>& previous) {
+    std::uniform_real_distribution<float> x(-150.0f, 950.0f);
+    std::uniform_real_distribution<float> y(-100.0f, 700.0f);
+    std::vector<EntityBatchEntry> next;
+    for (const EntityBatchEntry& entity : previous) {
+        if (rng() % 10 == 0) continue;  // Removed
+        EntityBatchEntry moved = entity;
+        if (rng() % 2) moved.posX += 3.3f;
+        if (rng() % 3 == 0) moved.posY -= 1.7f;
+        if (rng() % 8 == 0) moved.health = static_cast<uint8_t>(rng() % 200);
+        next.push_back(moved);
+    }
+    uint32_t id = previous.empty() ? 1 : previous.back().networkId + 1;
+    for (int added = static_cast<int>(rng() % 50); added > 0; --added) {
+        id += 1 + (rng() % 4 == 0 ? rng() % 100000 : 0);
+        next.push_back(EntityBatchEntry{id, x(rng), y(rng), static_cast<uint8_t>(rng() % 256)});
+    }
+    quantizeSnapshot(next);
+    sortByNetworkId(next);
+    return next;
+}
+
+// Encodes as the room does, one fragment per chunk of entries
+std::vector<std::vector<char>> encodeFragments(const std::vector<DeltaEntry>& deltas, std::size_t perFragment) {
+    std::vector<std::vector<char>> fragments;
+    for (std::size_t first = 0; first == 0 || first < deltas.size(); first += perFragment) {
+        fragments.emplace_back();
+        BitWriter writer(fragments.back());
+        uint32_t previousId = 0;
+        std::size_t bits = 0;
+        for (std::size_t e = first; e < std::min(deltas.size(), first + perFragment); ++e) {
+            bits += deltaEntryBits(deltas[e], previousId);
+            writeDeltaEntry(writer, deltas[e], previousId);
+            previousId = deltas[e].state.networkId;
+        }
+        CHECK(writer.bits() == bits);
+        writer.finish();
+    }
+    return fragments;
+}
+
+void testSnapshotDelta(std::mt19937& rng) {
+    std::vector<EntityBatchEntry> baseline;
+    std::vector<EntityBatchEntry> rebuilt;
+    for (int round = 0; round < 500; ++round) {
+        std::vector<EntityBatchEntry> current = randomSnapshot(rng, baseline);
+        std::vector<DeltaEntry> deltas;
+        diffSnapshots(baseline, current, deltas);
+
+        const std::size_t perFragment = 1 + rng() % 40;
+        auto fragments = encodeFragments(deltas, perFragment);
+
+        // Decoded in reverse order, as if the fragments arrived shuffled
+        std::vector<DeltaEntry> decoded;
+        for (std::size_t f = fragments.size(); f-- > 0;) {
+            std::size_t count = std::min(perFragment, deltas.size() - std::min(deltas.size(), f * perFragment));
+            CHECK(readSnapshotDelta(fragments[f].data(), fragments[f].size(), count, decoded));
+        }
+        std::sort(decoded.begin(), decoded.end(),
+                  [](const DeltaEntry& a, const DeltaEntry& b) { return a.state.networkId < b.state.networkId; });
+        CHECK(decoded.size() == deltas.size());
+
+        applySnapshotDelta(baseline, decoded, rebuilt);
+        CHECK(rebuilt.size() == current.size());
+        CHECK(std::memcmp(rebuilt.data(), current.data(), current.size() * sizeof(EntityBatchEntry)) == 0);
+
+        // Truncated or padded fragments are rejected
+        const std::vector<char>& fragment = fragments.front();
+        std::size_t count = std::min(perFragment, deltas.size());
+        std::vector<DeltaEntry> scratch;
+        if (!fragment.empty()) {
+            CHECK(!readSnapshotDelta(fragment.data(), fragment.size() - 1, count, scratch));
+        }
+        std::vector<char> padded = fragment;
+        padded.push_back(0);
+        CHECK(!readSnapshotDelta(padded.data(), padded.size(), count, scratch));
+
+        baseline = current;
+    }
+
+    // Nothing changed: nothing sent
+    std::vector<DeltaEntry> deltas;
+    diffSnapshots(baseline, baseline, deltas);
+    CHECK(deltas.empty());
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 rng(42);
+    testBitRoundTrip(rng);
+    testVarUint();
+    testReaderBounds();
+    testQuantizer(rng);
+    testSnapshotDelta(rng);
+    std::cout << "Snapshot codec: " << checks << " checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,164 @@
+// Tests of the hierarchical timer wheel (no network)
+//
+// Expiry ticks against a plain reference over random delays (cascades
+// included), stale handles, payloads changed in place, and callbacks that
+// cancel a timer due on the same tick or reschedule themselves. Exits with 1
+// on the first failed check.
+
+#include "../include/TimerWheel.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+int checks = 0;
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        ++checks;                                                                         \
+        if (!(condition)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": FAILED: " #condition << std::endl; \
+            std::exit(1);                                                                 \
+        }                                                                                 \
+    } while (0)
+
+using Wheel = TimerWheel<uint32_t>;
+
+void testExpiry(std::mt19937& rng) {
+    // Delays spread over every level: each timer fires exactly on its tick
+    Wheel wheel;
+    std::map<uint32_t, uint64_t> due;
+    std::map<uint32_t, Wheel::handle_type> handles;
+    std::uniform_int_distribution<int> level(0, 2);
+    for (uint32_t id = 0; id < 2000; ++id) {
+        uint64_t range = uint64_t{1} << (6 * (level(rng) + 1));
+        uint64_t delay = 1 + rng() % range;
+        handles[id] = wheel.schedule(delay, id);
+        due[id] = delay;
+    }
+    // Cancel a quarter of them up front
+    for (uint32_t id = 0; id < 2000; id += 4) {
+        CHECK(wheel.cancel(handles[id]));
+        CHECK(!wheel.cancel(handles[id]));  // Already cancelled
+        due.erase(id);
+    }
+    CHECK(wheel.pending() == due.size());
+
+    std::size_t fired = 0;
+    for (uint64_t tick = 0; tick < (uint64_t{1} << 18) && wheel.pending() > 0; ++tick) {
+        wheel.advance([&](uint32_t id) {
+            auto it = due.find(id);
+            CHECK(it != due.end());
+            CHECK(it->second == wheel.now());
+            ++fired;
+        });
+    }
+    CHECK(fired == due.size());
+    CHECK(wheel.pending() == 0);
+
+    // Handles of fired timers are stale, even once their node is reused
+    Wheel::handle_type fresh = wheel.schedule(5, 0);
+    for (const auto& handle : handles) {
+        CHECK(handle.second == fresh || !wheel.cancel(handle.second));
+    }
+    CHECK(wheel.cancel(fresh));
+    CHECK(!wheel.cancel(Wheel::invalid_handle));
+}
+
+void testCancelSameTick() {
+    // The first timer to fire cancels the others due on the same tick
+    Wheel wheel;
+    std::vector<Wheel::handle_type> handles;
+    for (uint32_t id = 0; id < 4; ++id) {
+        handles.push_back(wheel.schedule(3, id));
+    }
+    Wheel::handle_type later = wheel.schedule(4, 100);
+
+    std::vector<uint32_t> fired;
+    for (int tick = 0; tick < 3; ++tick) {
+        wheel.advance([&](uint32_t id) {
+            fired.push_back(id);
+            for (Wheel::handle_type handle : handles) {
+                wheel.cancel(handle);  // Its own handle is already stale
+            }
+        });
+    }
+    CHECK(fired.size() == 1);
+    CHECK(wheel.pending() == 1);
+
+    // The cancelled nodes went back to the pool once: no shared handles
+    std::set<Wheel::handle_type> reused;
+    for (uint32_t id = 0; id < 8; ++id) {
+        CHECK(reused.insert(wheel.schedule(10, id)).second);
+    }
+    CHECK(wheel.pending() == 9);
+    CHECK(wheel.cancel(later));
+    CHECK(wheel.pending() == 8);
+}
+
+void testRetarget() {
+    // A payload changed through find() is the one delivered on expiry
+    Wheel wheel;
+    Wheel::handle_type near = wheel.schedule(2, 1);
+    Wheel::handle_type far = wheel.schedule(300, 2);  // Cascades before firing
+    uint32_t* payload = wheel.find(far);
+    CHECK(payload != nullptr && *payload == 2);
+    *payload = 20;
+    CHECK(wheel.cancel(near));
+    CHECK(wheel.find(near) == nullptr);
+    CHECK(wheel.find(Wheel::invalid_handle) == nullptr);
+
+    std::vector<uint32_t> fired;
+    for (int tick = 0; tick < 300; ++tick) {
+        wheel.advance([&](uint32_t id) { fired.push_back(id); });
+    }
+    CHECK(fired.size() == 1 && fired[0] == 20);
+    CHECK(wheel.find(far) == nullptr);
+}
+
+void testRescheduleFromCallback() {
+    // A periodic timer rescheduling itself, and one-shots scheduled from it
+    Wheel wheel;
+    const uint64_t period = 7;
+    wheel.schedule(period, 0);
+    std::vector<uint64_t> periodic;
+    std::vector<uint64_t> oneShots;
+    for (int tick = 0; tick < 1000; ++tick) {
+        wheel.advance([&](uint32_t id) {
+            if (id == 0) {
+                periodic.push_back(wheel.now());
+                wheel.schedule(period, 0);
+                wheel.schedule(100, 1);  // Crosses a level 0 block
+                wheel.schedule(0, 2);    // Treated as 1: next tick, not this one
+            } else if (id == 1) {
+                oneShots.push_back(wheel.now());
+            } else {
+                CHECK(!periodic.empty() && wheel.now() == periodic.back() + 1);
+            }
+        });
+    }
+    CHECK(periodic.size() == 1000 / period);
+    for (std::size_t i = 0; i < periodic.size(); ++i) {
+        CHECK(periodic[i] == (i + 1) * period);
+    }
+    for (std::size_t i = 0; i < oneShots.size(); ++i) {
+        CHECK(oneShots[i] == periodic[i] + 100);
+    }
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 rng(42);
+    testExpiry(rng);
+    testCancelSameTick();
+    testRetarget();
+    testRescheduleFromCallback();
+    std::cout << "Timer wheel: " << checks << " checks passed" << std::endl;
+    return 0;
+}